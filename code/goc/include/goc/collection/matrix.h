@@ -8,6 +8,7 @@
 #define GOC_COLLECTION_MATRIX_H
 
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 #include "goc/lib/json.hpp"
@@ -17,19 +18,23 @@
 namespace goc
 {
 // Represents a matrix of dimension rxc of elements of type T.
+// The cells are stored contiguously by rows (row-major, the stride of a row is c).
 // Precondition: r>=0, c>=0.
 template<typename T>
 class Matrix : public Printable
 {
 public:
+	typedef typename std::vector<T>::iterator Row; // iterator to the first cell of a row, indexed as M[row][col].
+	typedef typename std::vector<T>::const_iterator ConstRow; // const iterator to the first cell of a row.
+	
 	// Creates an empty matrix.
 	Matrix(int row_count=0, int col_count=0)
-		: matrix_(row_count, std::vector<T>(col_count)), row_count_(row_count), col_count_(col_count)
+		: cells_(row_count * col_count), row_count_(row_count), col_count_(col_count)
 	{ }
 	
 	// Creates a matrix with row_count rows, col_count columns, and all cells with the default_element.
 	Matrix(int row_count, int col_count, const T& default_element)
-		: matrix_(row_count, std::vector<T>(col_count, default_element)), row_count_(row_count), col_count_(col_count)
+		: cells_(row_count * col_count, default_element), row_count_(row_count), col_count_(col_count)
 	{ }
 	
 	// Returns: the number of rows.
@@ -51,49 +56,53 @@ public:
 	}
 	
 	// Returns: the specified row.
-	std::vector<T>& operator[](int row)
+	Row operator[](int row)
 	{
-		return matrix_[row];
+		return cells_.begin() + row * col_count_;
 	}
 	
 	// Returns: the specified row.
-	const std::vector<T>& operator[](int row) const
+	ConstRow operator[](int row) const
 	{
-		return matrix_[row];
+		return cells_.begin() + row * col_count_;
 	}
 	
 	// Returns: the specified cell value.
-	T& operator()(int row, int col)
+	typename std::vector<T>::reference operator()(int row, int col)
 	{
-		return matrix_[row][col];
+		return cells_[row * col_count_ + col];
 	}
 	
 	// Returns: the specified cell value.
-	const T& operator()(int row, int col) const
+	typename std::vector<T>::const_reference operator()(int row, int col) const
 	{
-		return matrix_[row][col];
+		return cells_[row * col_count_ + col];
 	}
 	
 	// Returns: the specified cell value.
-	const T& at(int row, int col) const
+	// Exception: if the cell is out of range.
+	typename std::vector<T>::const_reference at(int row, int col) const
 	{
-		return matrix_.at(row).at(col);
+		if (row < 0 || row >= row_count_ || col < 0 || col >= col_count_) throw std::out_of_range("Matrix::at");
+		return cells_[row * col_count_ + col];
 	}
 	
 	// Clears the content of the matrix by setting the default value of T to each cell.
 	void clear()
 	{
-		matrix_ = std::vector<std::vector<T>>(row_count_, std::vector<T>(col_count_));
+		cells_.assign(row_count_ * col_count_, T());
 	}
 	
 	// Prints the matrix.
 	virtual void Print(std::ostream& os) const
 	{
-		os << matrix_;
+		std::vector<std::vector<T>> rows;
+		for (int r = 0; r < row_count_; ++r) rows.emplace_back((*this)[r], (*this)[r] + col_count_);
+		os << rows;
 	}
 
 private:
-	std::vector<std::vector<T>> matrix_;
+	std::vector<T> cells_; // cells_[r*col_count_+c] = cell (r, c).
 	int row_count_, col_count_;
 };
 
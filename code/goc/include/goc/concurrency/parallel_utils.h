@@ -0,0 +1,28 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_CONCURRENCY_PARALLEL_UTILS_H
+#define GOC_CONCURRENCY_PARALLEL_UTILS_H
+
+#include <functional>
+
+#include "goc/concurrency/thread_budget.h"
+
+namespace goc
+{
+// Executes f(i, worker) for every i in [0, n) using thread_count workers (worker \in [0, thread_count)).
+// Indices are handed to the workers dynamically, so each worker may execute many of them.
+// Observation: if thread_count <= 1, everything is executed in the calling thread with worker = 0.
+// Observation: if some call to f throws an exception, the remaining indices are skipped and the first exception
+// is rethrown in the calling thread once all workers finished.
+void parallel_for(int n, int thread_count, const std::function<void(int i, int worker)>& f);
+
+// Executes f(i) for every i in [0, n) with up to n threads (counting the calling thread) reserved from the budget.
+// The threads are released once all the calls finished.
+void parallel_for(int n, const std::function<void(int i)>& f, ThreadBudget& budget=ThreadBudget::Process());
+} // namespace goc
+
+#endif //GOC_CONCURRENCY_PARALLEL_UTILS_H
@@ -0,0 +1,74 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_CONCURRENCY_THREAD_BUDGET_H
+#define GOC_CONCURRENCY_THREAD_BUDGET_H
+
+#include <mutex>
+
+namespace goc
+{
+// Represents a number of threads shared by the parallel parts of a process (e.g. the LP/MIP solver and our own
+// algorithms), so that running them at the same time does not use more threads than the ones available.
+// Every running thread holds one unit of the budget. A component that wants to use k threads (counting the one that
+// calls it) reserves the k-1 extra ones, and it always gets at least its own thread.
+// Observation: it is thread-safe.
+class ThreadBudget
+{
+public:
+	// Creates a budget of thread_count threads, where the calling thread is already running.
+	explicit ThreadBudget(int thread_count);
+	
+	// Returns: the budget of the process (by default, it has as many threads as the hardware supports).
+	static ThreadBudget& Process();
+	
+	// Sets the total number of threads of the budget.
+	// Precondition: no threads are reserved.
+	void SetCapacity(int thread_count);
+	
+	// Returns: the total number of threads of the budget.
+	int Capacity() const;
+	
+	// Returns: the number of threads that are not in use.
+	int Available() const;
+	
+	// Reserves up to thread_count-1 extra threads for the calling thread.
+	// Returns: the number of threads the caller may use, in [1, thread_count] (its own thread plus the reserved ones).
+	int Reserve(int thread_count);
+	
+	// Releases the extra threads of a reservation.
+	// - thread_count: the value returned by Reserve.
+	void Release(int thread_count);
+	
+private:
+	mutable std::mutex mutex_; // guards capacity_ and used_.
+	int capacity_; // total number of threads.
+	int used_; // number of threads in use.
+};
+
+// Reservation of threads of a budget that is released when it goes out of scope.
+class ThreadReservation
+{
+public:
+	// Reserves up to thread_count threads (counting the calling thread) from the budget.
+	explicit ThreadReservation(int thread_count, ThreadBudget& budget=ThreadBudget::Process());
+	
+	ThreadReservation(const ThreadReservation&) = delete;
+	ThreadReservation& operator=(const ThreadReservation&) = delete;
+	
+	// Releases the threads.
+	~ThreadReservation();
+	
+	// Returns: the number of threads the owner of the reservation may use (at least 1).
+	int Count() const;
+	
+private:
+	ThreadBudget& budget_; // budget the threads were reserved from.
+	int count_; // number of threads of the reservation (counting the calling thread).
+};
+} // namespace goc
+
+#endif //GOC_CONCURRENCY_THREAD_BUDGET_H
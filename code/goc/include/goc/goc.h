@@ -14,23 +14,30 @@
 #include "goc/collection/matrix.h"
 #include "goc/collection/vector_map.h"
 
+#include "goc/concurrency/parallel_utils.h"
+#include "goc/concurrency/thread_budget.h"
+
 #include "goc/exception/exception_utils.h"
 
 #include "goc/graph/arc.h"
+#include "goc/graph/arc_table.h"
 #include "goc/graph/digraph.h"
 #include "goc/graph/edge.h"
+#include "goc/graph/filtered_digraph.h"
 #include "goc/graph/graph.h"
 #include "goc/graph/graph_path.h"
 #include "goc/graph/maxflow_mincut.h"
 #include "goc/graph/path_finding.h"
 #include "goc/graph/vertex.h"
 
+#include "goc/json/json_stream_parser.h"
 #include "goc/json/json_utils.h"
 
 #include "goc/lib/json.hpp"
 
 #include "goc/linear_programming/cuts/separation_routine.h"
 #include "goc/linear_programming/cuts/separation_strategy.h"
+#include "goc/linear_programming/model/basis.h"
 #include "goc/linear_programming/model/branch_priority.h"
 #include "goc/linear_programming/model/constraint.h"
 #include "goc/linear_programming/model/expression.h"
@@ -0,0 +1,171 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_GRAPH_ARC_TABLE_H
+#define GOC_GRAPH_ARC_TABLE_H
+
+#include <memory>
+#include <vector>
+
+#include "goc/collection/matrix.h"
+#include "goc/exception/exception_utils.h"
+#include "goc/graph/arc.h"
+#include "goc/graph/digraph.h"
+#include "goc/graph/vertex.h"
+#include "goc/lib/json.hpp"
+#include "goc/string/string_utils.h"
+
+namespace goc
+{
+// This class stores a value of type T for each arc of a digraph D and for each loop (v, v).
+// - The values of the arcs are stored contiguously in CSR format: the arcs leaving v have indices Begin(v), ...,
+//   End(v)-1 in the order of D.Successors(v), which are the same indices of the arcs in FilteredDigraph(D).
+// - The loops are not arcs of D, their values are stored apart (e.g. for boundary values of the vertices).
+// - The other pairs (i, j) have no value, reading them returns the default value of T.
+// Observation: copies of a table share the (immutable) index of the arcs.
+template<typename T>
+class ArcTable
+{
+public:
+	// Row of the table, indexed as table[i][j].
+	class Row
+	{
+	public:
+		Row(ArcTable* table, Vertex tail) : table_(table), tail_(tail) { }
+		
+		// Returns: the value of (tail, head).
+		// Exception: if (tail, head) is neither an arc nor a loop.
+		T& operator[](Vertex head) const { return table_->At(tail_, head); }
+	
+	private:
+		ArcTable* table_;
+		Vertex tail_;
+	};
+	
+	// Constant row of the table, indexed as table[i][j].
+	class ConstRow
+	{
+	public:
+		ConstRow(const ArcTable* table, Vertex tail) : table_(table), tail_(tail) { }
+		
+		// Returns: the value of (tail, head) (the default value of T if it is neither an arc nor a loop).
+		const T& operator[](Vertex head) const { return table_->At(tail_, head); }
+	
+	private:
+		const ArcTable* table_;
+		Vertex tail_;
+	};
+	
+	// Creates a table with no vertices.
+	ArcTable() : index_(std::make_shared<Index>()) { }
+	
+	// Creates a table with the default value of T for each arc and loop of D.
+	explicit ArcTable(const Digraph& D)
+	{
+		int n = D.VertexCount();
+		auto index = std::make_shared<Index>();
+		index->offset.assign(n+1, 0);
+		index->head.reserve(D.ArcCount());
+		index->arc_index = Matrix<int>(n, n, -1);
+		for (Vertex v: D.Vertices())
+		{
+			index->offset[v] = index->head.size();
+			for (Vertex w: D.Successors(v))
+			{
+				index->arc_index[v][w] = index->head.size();
+				index->head.push_back(w);
+			}
+		}
+		index->offset[n] = index->head.size();
+		index_ = index;
+		values_.resize(index->head.size());
+		loops_.resize(n);
+	}
+	
+	// Returns: number of vertices of the digraph.
+	int VertexCount() const { return loops_.size(); }
+	
+	// Returns: number of arcs of the digraph.
+	int ArcCount() const { return values_.size(); }
+	
+	// Returns: the index of the first arc leaving v.
+	int Begin(Vertex v) const { return index_->offset[v]; }
+	
+	// Returns: the index following the last arc leaving v.
+	int End(Vertex v) const { return index_->offset[v+1]; }
+	
+	// Returns: the head of the arc with index k.
+	Vertex Head(int k) const { return index_->head[k]; }
+	
+	// Returns: the index of arc e, or -1 if e \notin A(D).
+	int ArcIndex(Arc e) const { return index_->arc_index[e.tail][e.head]; }
+	
+	// Returns: the value of the arc with index k.
+	T& At(int k) { return values_[k]; }
+	
+	// Returns: the value of the arc with index k.
+	const T& At(int k) const { return values_[k]; }
+	
+	// Returns: the value of the loop (v, v).
+	T& Loop(Vertex v) { return loops_[v]; }
+	
+	// Returns: the value of the loop (v, v).
+	const T& Loop(Vertex v) const { return loops_[v]; }
+	
+	// Returns: the value of (i, j).
+	// Exception: if (i, j) is neither an arc nor a loop.
+	T& At(Vertex i, Vertex j)
+	{
+		if (i == j) return loops_[i];
+		int k = ArcIndex({i, j});
+		if (k == -1) fail("(" + STR(i) + ", " + STR(j) + ") is not an arc of the table.");
+		return values_[k];
+	}
+	
+	// Returns: the value of (i, j) (the default value of T if it is neither an arc nor a loop).
+	const T& At(Vertex i, Vertex j) const
+	{
+		static const T none = T();
+		if (i == j) return loops_[i];
+		int k = ArcIndex({i, j});
+		return k == -1 ? none : values_[k];
+	}
+	
+	// Returns: the row of the arcs leaving i.
+	Row operator[](Vertex i) { return Row(this, i); }
+	
+	// Returns: the row of the arcs leaving i.
+	ConstRow operator[](Vertex i) const { return ConstRow(this, i); }
+
+private:
+	// Index of the arcs in CSR format.
+	struct Index
+	{
+		std::vector<int> offset; // offset[v] = index of the first arc leaving v (offset[n] = |A(D)|).
+		std::vector<Vertex> head; // head[k] = head of the arc with index k.
+		Matrix<int> arc_index; // arc_index[i][j] = index of arc (i, j) or -1 if (i, j) \notin A(D).
+	};
+	
+	std::shared_ptr<const Index> index_; // index of the arcs, shared by the copies of the table.
+	std::vector<T> values_; // values_[k] = value of the arc with index k.
+	std::vector<T> loops_; // loops_[v] = value of the loop (v, v).
+};
+
+// Serializes the table as a dense matrix (the pairs without value have the default value of T).
+template<typename T>
+void to_json(nlohmann::json& j, const ArcTable<T>& table)
+{
+	int n = table.VertexCount();
+	j = std::vector<nlohmann::json>();
+	for (Vertex i = 0; i < n; ++i)
+	{
+		j.push_back(std::vector<nlohmann::json>());
+		for (Vertex k = 0; k < n; ++k) j.back().push_back(table[i][k]);
+	}
+}
+} // namespace goc
+
+#endif //GOC_GRAPH_ARC_TABLE_H
@@ -0,0 +1,71 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_GRAPH_FILTERED_DIGRAPH_H
+#define GOC_GRAPH_FILTERED_DIGRAPH_H
+
+#include <vector>
+
+#include "goc/collection/matrix.h"
+#include "goc/graph/arc.h"
+#include "goc/graph/digraph.h"
+#include "goc/graph/vertex.h"
+
+namespace goc
+{
+// This class represents a static view of a digraph D where arcs can be forbidden (hidden) without modifying D.
+// - The adjacency is stored in CSR format: the arcs leaving v have indices Begin(v), ..., End(v)-1.
+// - Forbidding or allowing an arc is a bit flip, it does not reallocate any structure.
+class FilteredDigraph
+{
+public:
+	// Creates a no-vertex filtered digraph.
+	FilteredDigraph() = default;
+
+	// Creates a view of D with no forbidden arcs.
+	FilteredDigraph(const Digraph& D);
+
+	// Returns: number of vertices in the digraph.
+	int VertexCount() const { return (int)offset_.size() - 1; }
+
+	// Returns: number of arcs in the digraph (including the forbidden ones).
+	int ArcCount() const { return (int)head_.size(); }
+
+	// Returns: the index of the first arc leaving v.
+	int Begin(Vertex v) const { return offset_[v]; }
+
+	// Returns: the index following the last arc leaving v.
+	int End(Vertex v) const { return offset_[v+1]; }
+
+	// Returns: the head of the arc with index k.
+	Vertex Head(int k) const { return head_[k]; }
+
+	// Returns: if the arc with index k is forbidden.
+	bool IsForbidden(int k) const { return forbidden_[k]; }
+
+	// Returns: the index of arc e, or -1 if e \notin A(D).
+	int ArcIndex(Arc e) const { return arc_index_[e.tail][e.head]; }
+
+	// Returns: if arc e \in A(D) and it is not forbidden.
+	bool IncludesArc(Arc e) const { return ArcIndex(e) != -1 && !forbidden_[ArcIndex(e)]; }
+
+	// Forbids exactly the arcs in 'arcs' (arcs not in A(D) are ignored), and allows the previously forbidden ones.
+	// Complexity: O(|previously forbidden arcs| + |arcs|).
+	void SetForbiddenArcs(const std::vector<Arc>& arcs);
+
+	// Returns: the arcs currently forbidden.
+	const std::vector<Arc>& ForbiddenArcs() const;
+
+private:
+	std::vector<int> offset_; // offset_[v] = index of the first arc leaving v (offset_[n] = |A(D)|).
+	std::vector<Vertex> head_; // head_[k] = head of the arc with index k.
+	Matrix<int> arc_index_; // arc_index_[i][j] = index of arc (i, j) or -1 if (i, j) \notin A(D).
+	std::vector<bool> forbidden_; // forbidden_[k] = arc with index k is forbidden.
+	std::vector<Arc> forbidden_arcs_; // arcs currently forbidden.
+};
+} // namespace goc
+
+#endif //GOC_GRAPH_FILTERED_DIGRAPH_H
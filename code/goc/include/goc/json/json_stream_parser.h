@@ -0,0 +1,84 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_JSON_JSON_STREAM_PARSER_H
+#define GOC_JSON_JSON_STREAM_PARSER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "goc/lib/json.hpp"
+
+namespace goc
+{
+// Receives the elements of a JSON value in document order (SAX style), so that it can be processed without building
+// the whole document in memory.
+class JSONHandler
+{
+public:
+	virtual ~JSONHandler() = default;
+	
+	virtual void Null() = 0;
+	
+	virtual void Boolean(bool value) = 0;
+	
+	virtual void Number(double value) = 0;
+	
+	// Called for numbers without fraction or exponent. By default they are notified as doubles.
+	virtual void Integer(long long value);
+	
+	virtual void String(const std::string& value) = 0;
+	
+	virtual void StartObject() = 0;
+	
+	// Called before the value of each key of the current object.
+	virtual void Key(const std::string& key) = 0;
+	
+	virtual void EndObject() = 0;
+	
+	virtual void StartArray() = 0;
+	
+	virtual void EndArray() = 0;
+};
+
+// Handler that builds the JSON document of the elements it receives (e.g. to keep the small parts of a large value).
+class JSONDocumentBuilder : public JSONHandler
+{
+public:
+	nlohmann::json document; // document built (it is complete when Done()).
+	
+	// Returns: if a whole value was received.
+	bool Done() const;
+	
+	virtual void Null();
+	virtual void Boolean(bool value);
+	virtual void Number(double value);
+	virtual void Integer(long long value);
+	virtual void String(const std::string& value);
+	virtual void StartObject();
+	virtual void Key(const std::string& key);
+	virtual void EndObject();
+	virtual void StartArray();
+	virtual void EndArray();
+
+private:
+	std::vector<nlohmann::json*> stack_; // open objects and arrays, the last one is the innermost.
+	std::string key_; // key of the next value if the innermost container is an object.
+	bool done_ = false; // a whole value was received.
+	
+	// Adds the value to the innermost container (or sets the document if there is none).
+	// Returns: the added value.
+	nlohmann::json* Add(const nlohmann::json& value);
+};
+
+// Parses one JSON value from the stream and sends its elements to the handler. The stream is left after the value,
+// so that several values can be parsed from it one after another.
+// Exception: if the stream does not start with a valid JSON value.
+void parse_json_stream(std::istream& is, JSONHandler* handler);
+} // namespace goc
+
+#endif //GOC_JSON_JSON_STREAM_PARSER_H
@@ -16,6 +16,7 @@
 #include "goc/linear_programming/solver/lp_solver.h"
 #include "goc/linear_programming/solver/cg_solver.h"
 #include "goc/log/cg_execution_log.h"
+#include "goc/math/number_utils.h"
 
 namespace goc
 {
@@ -25,13 +26,23 @@ namespace goc
 // pricing_function: Function that given a set of dual variables and the objective value finds and adds entering variables to the master formulation base.
 // lp_solver: Linear relaxation solver.
 // options: Which options of the execution to keep track of.
+// stabilization: Dual stabilization strategy used to compute the duals sent to the pricing function.
+// smoothing_factor: Weight in [0, 1) of the point kept by the stabilization strategy.
+// column_sum_bound: Upper bound K on the sum of the variables in an optimal solution, used for the Lagrangian bound.
+// cutoff: The column generation stops (status Cutoff) when the Lagrangian bound exceeds this value.
+// gap_tolerance: The column generation stops when the master value is within this gap of the Lagrangian bound.
 // Returns: the execution log of the column generation with the specified options.
 CGExecutionLog solve_colgen(Formulation* formulation,
 				   std::ostream* screen_output,
 				   Duration time_limit,
 				   const PricingFunction& pricing_function,
 				   LPSolver* lp_solver,
-				   const std::unordered_set<CGOption>& options);
+				   const std::unordered_set<CGOption>& options,
+				   CGStabilization stabilization=CGStabilization::None,
+				   double smoothing_factor=0.0,
+				   double column_sum_bound=INFTY,
+				   double cutoff=INFTY,
+				   double gap_tolerance=0.0);
 } // namespace goc
 
 #endif //GOC_LINEAR_PROGRAMMING_COLGEN_COLGEN_H
@@ -33,6 +33,10 @@ public:
 	// Returns: the index of the constraint added.
 	virtual int AddConstraint(const Constraint& constraint);
 	
+	// Adds the rows to the model at once (adding the constraints one by one costs a call to the solver each).
+	// Returns: the index of the first constraint added (the rest follow in the same order than the rows).
+	virtual int AddRows(const std::vector<Row>& rows);
+	
 	// Removes the constraint with index 'constraint_index' from the formulation.
 	// If such constraint does not exists, it does nothing.
 	virtual void RemoveConstraint(int constraint_index);
@@ -50,10 +54,19 @@ public:
 	// Returns: a Variable with its correspondent name and index in the formulation.
 	virtual Variable AddVariable(const std::string& name, VariableDomain domain, double lower_bound, double upper_bound);
 	
+	// Adds the columns to the model at once (adding the variables and setting their coefficients one by one costs a
+	// call to the solver each).
+	// Returns: the Variables added, in the same order than the columns.
+	virtual std::vector<Variable> AddColumns(const std::vector<Column>& columns);
+	
 	// Removes the variable with the same index than the one given as a parameter.
 	// Observation: The name is ignored.
 	virtual void RemoveVariable(const Variable& variable);
 	
+	// Removes all the variables in 'variables' at once (removing them one by one costs linear time each).
+	// Observation: the remaining variables keep their relative order.
+	virtual void RemoveVariables(const std::vector<Variable>& variables);
+	
 	// Sets the domain of the variable in the model. Domain might be Real, Integer, or Binary.
 	virtual void SetVariableDomain(const Variable& variable, VariableDomain domain);
 	
@@ -61,6 +74,15 @@ public:
 	// Observation: use -INFTY or INFTY constants to specify no bounds.
 	virtual void SetVariableBound(const Variable& v, double lower_bound, double upper_bound);
 	
+	// Sets the same lower and upper bounds to all the variables with a single call to the solver.
+	// Observation: use -INFTY or INFTY constants to specify no bounds.
+	virtual void SetVariableBounds(const std::vector<Variable>& variables, double lower_bound, double upper_bound);
+	
+	// Sets the bounds [lower_bounds[k], upper_bounds[k]] to variables[k] for all k with a single call to the solver.
+	// Observation: use -INFTY or INFTY constants to specify no bounds.
+	virtual void SetVariableBounds(const std::vector<Variable>& variables, const std::vector<double>& lower_bounds,
+		const std::vector<double>& upper_bounds);
+	
 	// Sets the lower bound of the variable in the formulation.
 	// Observation: use -INFTY or INFTY constants to specify no bounds.
 	virtual void SetVariableLowerBound(const Variable& v, double lower_bound);
@@ -131,6 +153,14 @@ public:
 	//	- verbose: if true, then the first violated constraint is printed in clog.
 	virtual bool IsFeasibleValuation(const Valuation& v, bool verbose=false) const;
 	
+	// Sets the basis to warm start the next linear relaxation solved (it is used only once).
+	// Observation: variables and constraints added after the basis was taken start nonbasic and with a basic slack
+	// respectively. If the basis has more variables or constraints than the formulation, it is ignored.
+	virtual void SetBasis(const Basis& basis);
+	
+	// Returns: the basis set with SetBasis (empty if none was set), and clears it.
+	Basis ExtractBasis();
+	
 	// Returns: a copy in the heap of the current formulation.
 	// Observation: memory should be managed by the receiver and the pointer should be freed.
 	virtual Formulation* Copy() const;
@@ -142,6 +172,16 @@ public:
 	
 	CPXLPptr Problem() const;
 	
+	// The CPLEX problem is always an LP (the variable domains are kept by the formulation), so that solving the linear
+	// relaxation does not need to change the problem type. This method makes Problem() return a MILP copy of it, until
+	// SwitchToLinearProblem() is called. The copy is kept between calls: the columns added to the formulation since the
+	// last call are appended to it and bound changes are applied to it, any other change creates it again.
+	// Observation: changes made to the formulation while the MILP copy is active only apply to the copy.
+	void SwitchToIntegerProblem();
+	
+	// Makes Problem() return the LP problem again.
+	void SwitchToLinearProblem();
+	
 private:
 	// Constructor for the case when an environment and problem were already existing.
 	CplexFormulation(const std::shared_ptr<cpxenv>& env_memory_handler, CPXLPptr problem);
@@ -150,10 +190,22 @@ private:
 													// references are alive. This is necessary in case of a problem copy.
 	CPXENVptr env_; // CPLEX environment.
 	CPXLPptr problem_; // CPLEX problem.
+	CPXLPptr integer_problem_; // MILP copy of the problem (nullptr if it was not created yet).
+	bool integer_active_; // if problem_ and integer_problem_ are swapped (i.e. the MILP copy is being solved).
+	int integer_column_count_; // number of columns already in integer_problem_ (-1 if it must be created again).
+	std::vector<VariableDomain> variable_domains_; // domain of each variable.
 	std::vector<std::string> variable_names_; // Need to keep names because CPLEX keeps pointer to them.
 	std::vector<int*> variable_indices_; // CPLEX indices of the variables in the variables_ vector.
 	std::vector<int*> constraint_indices_; // CPLEX indices of the constraints in the constraints_ vector.
 	std::vector<SeparationRoutine*> lazy_constraints_; // lazy constraints of the model.
+	Basis basis_; // basis to warm start the next linear relaxation (empty if none).
+	
+	// Marks the MILP copy as outdated, because the problem changed in some way other than adding columns or changing
+	// bounds.
+	void InvalidateIntegerProblem();
+	
+	// Changes the bounds of the problem (as CPXchgbds), and of the columns already in the MILP copy.
+	void ChangeBounds(int count, const int* indices, const char* type, const double* bd);
 };
 } // namespace goc
 
@@ -24,8 +24,13 @@ void freeprob(CPXENVptr env, CPXLPptr* lp_p);
 void newcols(CPXENVptr env, CPXLPptr lp, int ccnt, double const* obj, double const* lb,
 					double const* ub, char const* xctype, char** colname);
 
+void addcols(CPXENVptr env, CPXLPptr lp, int ccnt, int nzcnt, double const* obj, int const* cmatbeg,
+			 int const* cmatind, double const* cmatval, double const* lb, double const* ub, char** colname);
+
 void delcols(CPXCENVptr env, CPXLPptr lp, int begin, int end);
 
+void delsetcols(CPXCENVptr env, CPXLPptr lp, int* delstat);
+
 void chgctype(CPXENVptr env, CPXLPptr lp, int cnt, int const* indices, char const* xctype);
 
 void getctype(CPXENVptr env, CPXCLPptr lp, char* xctype, int begin, int end);
@@ -94,6 +99,9 @@ void getsense(CPXCENVptr env, CPXCLPptr lp, char* sense, int begin, int end);
 void getrows(CPXCENVptr env, CPXCLPptr lp, int* nzcnt_p, int* rmatbeg, int* rmatind, double* rmatval,
 			 int rmatspace, int* surplus_p, int begin, int end);
 
+void getcols(CPXCENVptr env, CPXCLPptr lp, int* nzcnt_p, int* cmatbeg, int* cmatind, double* cmatval,
+			 int cmatspace, int* surplus_p, int begin, int end);
+
 void setintparam(CPXENVptr env, int whichparam, CPXINT newvalue);
 
 void setdblparam(CPXENVptr env, int whichparam, double newvalue);
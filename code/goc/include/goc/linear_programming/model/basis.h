@@ -0,0 +1,29 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef GOC_LINEAR_PROGRAMMING_MODEL_BASIS_H
+#define GOC_LINEAR_PROGRAMMING_MODEL_BASIS_H
+
+#include <vector>
+
+namespace goc
+{
+// Represents a basis of the simplex algorithm for a linear relaxation, this is, the status of each variable and of
+// the slack of each constraint. It is used to warm start a relaxation from the optimal basis of a similar one.
+// Observation: an empty basis (no variable statuses) represents no basis.
+struct Basis
+{
+	enum Status { AtLower, Basic, AtUpper, FreeSuperbasic };
+	
+	std::vector<Status> variable_status; // variable_status[i] = status of the variable with index i.
+	std::vector<Status> constraint_status; // constraint_status[i] = status of the slack of the constraint with index i.
+	
+	// Returns: if the basis has no statuses.
+	bool IsEmpty() const { return variable_status.empty(); }
+};
+} // namespace goc
+
+#endif //GOC_LINEAR_PROGRAMMING_MODEL_BASIS_H
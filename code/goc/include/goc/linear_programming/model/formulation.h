@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "goc/linear_programming/model/basis.h"
 #include "goc/linear_programming/model/variable.h"
 #include "goc/linear_programming/model/valuation.h"
 #include "goc/linear_programming/model/constraint.h"
@@ -24,6 +25,24 @@ namespace goc
 // Represents the domain of the variables in a (mixed integer) linear programming model.
 enum class VariableDomain { Real, Integer, Binary };
 
+// Represents a variable to be added to a formulation together with its coefficients in the model.
+struct Column
+{
+	std::string name; // name of the variable.
+	VariableDomain domain; // domain of the variable.
+	double lower_bound, upper_bound; // bounds of the variable (use -INFTY or INFTY for no bounds).
+	double objective_coefficient; // coefficient of the variable in the objective function.
+	std::vector<std::pair<int, double>> coefficients; // (constraint index, coefficient) of the non-zero coefficients.
+};
+
+// Represents a constraint to be added to a formulation given by its non-zero coefficients.
+struct Row
+{
+	enum Constraint::Sense sense; // sense of the constraint.
+	double right_hand_side; // constant on the right side of the constraint.
+	std::vector<std::pair<int, double>> coefficients; // (variable index, coefficient) of the non-zero coefficients.
+};
+
 // Represents a (mixed integer) linear programming model.
 // It is a protocol designed to abstract specific implementations for solvers (CPLEX, Gurobi, etc).
 class Formulation : public Printable
@@ -39,6 +58,10 @@ public:
 	// Returns: the index of the constraint added.
 	virtual int AddConstraint(const Constraint& constraint) = 0;
 	
+	// Adds the rows to the model at once (adding the constraints one by one costs a call to the solver each).
+	// Returns: the index of the first constraint added (the rest follow in the same order than the rows).
+	virtual int AddRows(const std::vector<Row>& rows) = 0;
+	
 	// Removes the constraint with index 'constraint_index' from the formulation.
 	// If such constraint does not exists, it does nothing.
 	virtual void RemoveConstraint(int constraint_index) = 0;
@@ -56,10 +79,19 @@ public:
 	// Returns: a Variable with its correspondent name and index in the formulation.
 	virtual Variable AddVariable(const std::string& name, VariableDomain domain=VariableDomain::Real, double lower_bound=-INFTY, double upper_bound=INFTY) = 0;
 	
+	// Adds the columns to the model at once (adding the variables and setting their coefficients one by one costs a
+	// call to the solver each).
+	// Returns: the Variables added, in the same order than the columns.
+	virtual std::vector<Variable> AddColumns(const std::vector<Column>& columns) = 0;
+	
 	// Removes the variable with the same index than the one given as a parameter.
 	// Observation: The name is ignored.
 	virtual void RemoveVariable(const Variable& variable) = 0;
 	
+	// Removes all the variables in 'variables' at once (removing them one by one costs linear time each).
+	// Observation: the remaining variables keep their relative order.
+	virtual void RemoveVariables(const std::vector<Variable>& variables) = 0;
+	
 	// Sets the domain of the variable in the model. Domain might be Real, Integer, or Binary.
 	virtual void SetVariableDomain(const Variable& variable, VariableDomain domain) = 0;
 	
@@ -67,6 +99,15 @@ public:
 	// Observation: use -INFTY or INFTY constants to specify no bounds.
 	virtual void SetVariableBound(const Variable& v, double lower_bound, double upper_bound) = 0;
 	
+	// Sets the same lower and upper bounds to all the variables with a single call to the solver.
+	// Observation: use -INFTY or INFTY constants to specify no bounds.
+	virtual void SetVariableBounds(const std::vector<Variable>& variables, double lower_bound, double upper_bound) = 0;
+	
+	// Sets the bounds [lower_bounds[k], upper_bounds[k]] to variables[k] for all k with a single call to the solver.
+	// Observation: use -INFTY or INFTY constants to specify no bounds.
+	virtual void SetVariableBounds(const std::vector<Variable>& variables, const std::vector<double>& lower_bounds,
+		const std::vector<double>& upper_bounds) = 0;
+	
 	// Sets the lower bound of the variable in the formulation.
 	// Observation: use -INFTY or INFTY constants to specify no bounds.
 	virtual void SetVariableLowerBound(const Variable& v, double lower_bound) = 0;
@@ -137,6 +178,11 @@ public:
 	// 	- verbose: indicates if a contraint violated should be showed.
 	virtual bool IsFeasibleValuation(const Valuation& v, bool verbose=false) const = 0;
 	
+	// Sets the basis to warm start the next linear relaxation solved (it is used only once).
+	// Observation: variables and constraints added after the basis was taken start nonbasic and with a basic slack
+	// respectively. If the basis has more variables or constraints than the formulation, it is ignored.
+	virtual void SetBasis(const Basis& basis) = 0;
+	
 	// Returns: a copy in the heap of the current formulation.
 	// Observation: memory should be managed by the receiver and the pointer should be freed.
 	virtual Formulation* Copy() const = 0;
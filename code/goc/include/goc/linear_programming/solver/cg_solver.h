@@ -12,6 +12,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "goc/lib/json.hpp"
 #include "goc/linear_programming/model/formulation.h"
 #include "goc/linear_programming/solver/lp_solver.h"
 #include "goc/log/cg_execution_log.h"
@@ -24,14 +25,26 @@ namespace goc
 //							advantage: saving the space of the iteration logs.
 // - ScreenOutput: 			if not included, the output will not be stored.
 //							advantage: saving space.
-enum class CGOption { IterationsInformation, ScreenOutput };
+// - Basis:					if not included, {basis} will not be filled.
+//							advantage: getting it is linear in the size of the model.
+enum class CGOption { IterationsInformation, ScreenOutput, Basis };
+
+// Dual stabilization strategies. The pricing function receives the stabilized duals
+// pi_s = alpha * pi_c + (1 - alpha) * pi, where pi are the duals of the restricted master problem and pi_c is a point
+// kept by the strategy. If the pricing does not add columns for pi_s (mispricing), it is called again with pi.
+// - None:		pi_s = pi.
+// - Wentges:	pi_c is the stability center, the point (stabilized or not) with the best Lagrangian bound found.
+// - InOut:		pi_c is the in-point, the last stabilized point where a mispricing occurred (i.e. a dual feasible point).
+enum class CGStabilization { None, Wentges, InOut };
 
 // Function type for the pricing solver.
 // - duals: the dual variables of the iteration.
 // - incumbent_value: the value of the lp relaxation.
 // - time_limit: maximum time to execute the pricing algorithm.
-// - execution_log: pointer to the cg execution log to add the iteration log.
-typedef std::function<void(const std::vector<double>& duals, double incumbent_value, Duration time_limit, CGExecutionLog* cg_execution_log)> PricingFunction;
+// - execution_log: pointer to the cg execution log to add the iteration log (stabilized_duals tells if the duals are
+//	the stabilized ones instead of the duals of the master).
+// Returns: a lower bound on the minimum reduced cost of the columns for the duals (-INFTY if none is known).
+typedef std::function<double(const std::vector<double>& duals, double incumbent_value, Duration time_limit, CGExecutionLog* cg_execution_log)> PricingFunction;
 
 // Class representing a solver for column generation. Its purpose is to abstract the
 // specific solver implementations from the algorithms.
@@ -46,10 +59,24 @@ public:
 	goc::LPSolver* lp_solver;
 	// A function that receives the current lp iteration and adds variables to the lp. The column generation will
 	// continue as long as the pricing function adds variables (or constraints) to the lp at a given iteration.
+	// Observation: if a stabilization is used, it may be called twice in an iteration (first with the stabilized duals).
 	PricingFunction pricing_function;
+	// Dual stabilization strategy.
+	CGStabilization stabilization;
+	// Weight alpha in [0, 1) of the point kept by the stabilization strategy.
+	double smoothing_factor;
+	// K: upper bound on the sum of the variables in an optimal solution. When the pricing function returns a lower bound
+	// min_rc for the duals of the master, z_LP + K * min_rc is a Lagrangian bound on the optimum (INFTY to disable it).
+	// For the stabilized duals pi_s the bound is pi_s * b + K * min_rc, which requires lower bounds 0 on the variables.
+	double column_sum_bound;
+	// The column generation stops with status Cutoff when the Lagrangian bound exceeds this value.
+	double cutoff;
+	// The column generation stops when the gap between the master value and the Lagrangian bound is at most this value.
+	double gap_tolerance;
 	
 	// Creates a default column generation solver (no output, time_limit=2hs, lp_solver=CPLEX,
-	// 	pricing_function=DONOTHING).
+	// 	pricing_function=DONOTHING, stabilization=None, smoothing_factor=0.8, column_sum_bound=cutoff=INFTY,
+	//	gap_tolerance=0).
 	CGSolver();
 	
 	// Solves the formulation using a column generation procedure.
@@ -60,6 +87,11 @@ public:
 	// Returns: a formulation compatible with the solver.
 	static Formulation* NewFormulation();
 };
+
+std::ostream& operator<<(std::ostream& os, CGStabilization stabilization);
+
+// Parses the stabilization from its name ("None", "Wentges" or "InOut").
+void from_json(const nlohmann::json& j, CGStabilization& stabilization);
 } // namespace goc
 
 #endif //GOC_LINEAR_PROGRAMMING_SOLVER_CG_SOLVER_H
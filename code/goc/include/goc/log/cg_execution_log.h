@@ -13,6 +13,7 @@
 
 #include "goc/base/maybe.h"
 #include "goc/lib/json.hpp"
+#include "goc/linear_programming/model/basis.h"
 #include "goc/linear_programming/model/valuation.h"
 #include "goc/log/log.h"
 #include "goc/time/duration.h"
@@ -20,7 +21,8 @@
 namespace goc
 {
 // All the status that can result from a column generation execution.
-enum class CGStatus { DidNotStart, Infeasible, Unbounded, TimeLimitReached, MemoryLimitReached, Optimum };
+// - Cutoff: the Lagrangian bound exceeded the cutoff value before the column generation finished.
+enum class CGStatus { DidNotStart, Infeasible, Unbounded, TimeLimitReached, MemoryLimitReached, Cutoff, Optimum };
 
 // This class stores information about the execution of a column generation algorithm.
 // It is compatible with the Kaleidoscope kd_type "cg".
@@ -32,8 +34,12 @@ public:
 	Maybe<CGStatus> status; // the status of the execution
 	Maybe<Valuation> incumbent; // best solution found.
 	Maybe<double> incumbent_value; // value of the best solution found.
+	Maybe<Basis> basis; // optimal basis of the final restricted master problem.
+	Maybe<double> lagrangian_bound; // best Lagrangian bound found (the master value if no column prices out).
 	Maybe<int> columns_added; // total number of columns added in the colgen.
 	Maybe<int> iteration_count; // number of pricing iterations solved.
+	Maybe<int> mispricing_count; // number of iterations where the pricing found no columns for the stabilized duals.
+	bool stabilized_duals = false; // if the pricing function is being called with the stabilized duals (not logged).
 	Maybe<Duration> pricing_time; // time spent solving the pricing problem.
 	Maybe<Duration> lp_time; // time spent solving the lp relaxation.
 	Maybe<std::vector<nlohmann::json>> iterations; // logs of the pricing iterations.
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "goc/base/maybe.h"
+#include "goc/linear_programming/model/basis.h"
 #include "goc/linear_programming/model/valuation.h"
 #include "goc/log/log.h"
 #include "goc/time/duration.h"
@@ -35,6 +36,7 @@ public:
 	Maybe<int> variable_count; // number of variables in the lp.
 	Maybe<int> constraint_count; // number of constraints in the lp.
 	Maybe<std::vector<double>> duals; // vector of the dual variables associated to the rows in the solution.
+	Maybe<Basis> basis; // optimal basis (only if the relaxation was solved to optimality).
 	
 	LPExecutionLog() = default;
 	
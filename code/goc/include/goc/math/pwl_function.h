@@ -110,6 +110,12 @@ public:
 	// Returns: the restricted function.
 	PWLFunction RestrictImage(const Interval& image) const;
 	
+	// Merges the consecutive pieces that are nearly collinear.
+	// Returns: a function g with the same domain and at most the same number of pieces, such that
+	// f(x) <= g(x) <= f(x) + tolerance for every x \in dom(f).
+	// Observation: the discontinuities of f are kept, and if f is non decreasing then g is non decreasing.
+	PWLFunction Simplify(double tolerance) const;
+	
 	// Prints the function.
 	// Format: [p1, p2, ..., pn].
 	virtual void Print(std::ostream& os) const;
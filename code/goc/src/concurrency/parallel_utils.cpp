@@ -0,0 +1,57 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "goc/concurrency/parallel_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace goc
+{
+void parallel_for(int n, int thread_count, const function<void(int i, int worker)>& f)
+{
+	thread_count = max(1, min(thread_count, n));
+	if (thread_count == 1)
+	{
+		for (int i = 0; i < n; ++i) f(i, 0);
+		return;
+	}
+	
+	atomic<int> next(0); // next index to execute.
+	exception_ptr error = nullptr; // first exception thrown by a worker.
+	mutex error_lock;
+	auto work = [&] (int worker) {
+		for (int i = next++; i < n; i = next++)
+		{
+			try { f(i, worker); }
+			catch (...)
+			{
+				lock_guard<mutex> guard(error_lock);
+				if (!error) error = current_exception();
+				next = n; // stop handing out indices.
+			}
+		}
+	};
+	
+	vector<thread> workers;
+	for (int w = 1; w < thread_count; ++w) workers.emplace_back(work, w);
+	work(0);
+	for (auto& t: workers) t.join();
+	if (error) rethrow_exception(error);
+}
+
+void parallel_for(int n, const function<void(int i)>& f, ThreadBudget& budget)
+{
+	ThreadReservation threads(min(n, budget.Capacity()), budget);
+	parallel_for(n, threads.Count(), [&] (int i, int worker) { f(i); });
+}
+} // namespace goc
@@ -0,0 +1,76 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "goc/concurrency/thread_budget.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "goc/exception/exception_utils.h"
+
+using namespace std;
+
+namespace goc
+{
+ThreadBudget::ThreadBudget(int thread_count) : capacity_(max(1, thread_count)), used_(1)
+{
+	
+}
+
+ThreadBudget& ThreadBudget::Process()
+{
+	static ThreadBudget budget(thread::hardware_concurrency());
+	return budget;
+}
+
+void ThreadBudget::SetCapacity(int thread_count)
+{
+	lock_guard<mutex> guard(mutex_);
+	if (used_ > 1) fail("Can not change the capacity of a thread budget with reserved threads.");
+	capacity_ = max(1, thread_count);
+}
+
+int ThreadBudget::Capacity() const
+{
+	lock_guard<mutex> guard(mutex_);
+	return capacity_;
+}
+
+int ThreadBudget::Available() const
+{
+	lock_guard<mutex> guard(mutex_);
+	return max(0, capacity_ - used_);
+}
+
+int ThreadBudget::Reserve(int thread_count)
+{
+	lock_guard<mutex> guard(mutex_);
+	int extra = max(0, min(thread_count - 1, capacity_ - used_));
+	used_ += extra;
+	return 1 + extra;
+}
+
+void ThreadBudget::Release(int thread_count)
+{
+	lock_guard<mutex> guard(mutex_);
+	used_ -= max(0, thread_count - 1);
+}
+
+ThreadReservation::ThreadReservation(int thread_count, ThreadBudget& budget) : budget_(budget)
+{
+	count_ = budget_.Reserve(thread_count);
+}
+
+ThreadReservation::~ThreadReservation()
+{
+	budget_.Release(count_);
+}
+
+int ThreadReservation::Count() const
+{
+	return count_;
+}
+} // namespace goc
@@ -0,0 +1,49 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "goc/graph/filtered_digraph.h"
+
+using namespace std;
+
+namespace goc
+{
+FilteredDigraph::FilteredDigraph(const Digraph& D)
+{
+	int n = D.VertexCount();
+	offset_.assign(n+1, 0);
+	head_.reserve(D.ArcCount());
+	arc_index_ = Matrix<int>(n, n, -1);
+	for (Vertex v: D.Vertices())
+	{
+		offset_[v] = head_.size();
+		for (Vertex w: D.Successors(v))
+		{
+			arc_index_[v][w] = head_.size();
+			head_.push_back(w);
+		}
+	}
+	offset_[n] = head_.size();
+	forbidden_.assign(head_.size(), false);
+}
+
+void FilteredDigraph::SetForbiddenArcs(const vector<Arc>& arcs)
+{
+	for (Arc e: forbidden_arcs_) forbidden_[ArcIndex(e)] = false;
+	forbidden_arcs_.clear();
+	for (Arc e: arcs)
+	{
+		int k = ArcIndex(e);
+		if (k == -1 || forbidden_[k]) continue;
+		forbidden_[k] = true;
+		forbidden_arcs_.push_back(e);
+	}
+}
+
+const vector<Arc>& FilteredDigraph::ForbiddenArcs() const
+{
+	return forbidden_arcs_;
+}
+} // namespace goc
@@ -0,0 +1,314 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "goc/json/json_stream_parser.h"
+
+#include <cstdlib>
+
+#include "goc/exception/exception_utils.h"
+
+using namespace std;
+using namespace nlohmann;
+
+namespace goc
+{
+namespace
+{
+// Recursive descent parser that reads the characters directly from the stream buffer.
+class StreamParser
+{
+public:
+	StreamParser(istream& is, JSONHandler* handler) : buffer_(is.rdbuf()), handler_(handler)
+	{
+	
+	}
+	
+	void ParseValue()
+	{
+		SkipWhitespace();
+		int c = Peek();
+		if (c == '{') ParseObject();
+		else if (c == '[') ParseArray();
+		else if (c == '"') handler_->String(ParseString());
+		else if (c == 't') { ParseLiteral("true"); handler_->Boolean(true); }
+		else if (c == 'f') { ParseLiteral("false"); handler_->Boolean(false); }
+		else if (c == 'n') { ParseLiteral("null"); handler_->Null(); }
+		else if (c == '-' || isdigit(c)) ParseNumber();
+		else Fail("unexpected character");
+	}
+
+private:
+	streambuf* buffer_; // buffer of the stream being parsed.
+	JSONHandler* handler_; // receives the elements of the value.
+	
+	int Peek()
+	{
+		return buffer_->sgetc();
+	}
+	
+	int Next()
+	{
+		return buffer_->sbumpc();
+	}
+	
+	void Fail(const string& reason)
+	{
+		fail("Invalid JSON stream: " + reason + ".");
+	}
+	
+	void Expect(char expected)
+	{
+		if (Next() != expected) Fail(string("expected '") + expected + "'");
+	}
+	
+	void SkipWhitespace()
+	{
+		while (Peek() == ' ' || Peek() == '\t' || Peek() == '\n' || Peek() == '\r') Next();
+	}
+	
+	void ParseLiteral(const string& literal)
+	{
+		for (char c: literal) Expect(c);
+	}
+	
+	void ParseObject()
+	{
+		Expect('{');
+		handler_->StartObject();
+		SkipWhitespace();
+		if (Peek() == '}')
+		{
+			Next();
+			handler_->EndObject();
+			return;
+		}
+		while (true)
+		{
+			SkipWhitespace();
+			if (Peek() != '"') Fail("expected an object key");
+			handler_->Key(ParseString());
+			SkipWhitespace();
+			Expect(':');
+			ParseValue();
+			SkipWhitespace();
+			int c = Next();
+			if (c == '}') break;
+			if (c != ',') Fail("expected ',' or '}'");
+		}
+		handler_->EndObject();
+	}
+	
+	void ParseArray()
+	{
+		Expect('[');
+		handler_->StartArray();
+		SkipWhitespace();
+		if (Peek() == ']')
+		{
+			Next();
+			handler_->EndArray();
+			return;
+		}
+		while (true)
+		{
+			ParseValue();
+			SkipWhitespace();
+			int c = Next();
+			if (c == ']') break;
+			if (c != ',') Fail("expected ',' or ']'");
+		}
+		handler_->EndArray();
+	}
+	
+	void ParseNumber()
+	{
+		string text;
+		bool integer = true;
+		while (true)
+		{
+			int c = Peek();
+			if (isdigit(c) || c == '-' || c == '+') text.push_back(Next());
+			else if (c == '.' || c == 'e' || c == 'E') { integer = false; text.push_back(Next()); }
+			else break;
+		}
+		char* end;
+		if (integer)
+		{
+			long long value = strtoll(text.c_str(), &end, 10);
+			if (*end != '\0') Fail("invalid number " + text);
+			handler_->Integer(value);
+		}
+		else
+		{
+			double value = strtod(text.c_str(), &end);
+			if (*end != '\0') Fail("invalid number " + text);
+			handler_->Number(value);
+		}
+	}
+	
+	// Appends the UTF-8 encoding of the code point to s.
+	void AppendUTF8(unsigned code_point, string* s)
+	{
+		if (code_point < 0x80)
+		{
+			s->push_back(code_point);
+		}
+		else if (code_point < 0x800)
+		{
+			s->push_back(0xC0 | (code_point >> 6));
+			s->push_back(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			s->push_back(0xE0 | (code_point >> 12));
+			s->push_back(0x80 | ((code_point >> 6) & 0x3F));
+			s->push_back(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			s->push_back(0xF0 | (code_point >> 18));
+			s->push_back(0x80 | ((code_point >> 12) & 0x3F));
+			s->push_back(0x80 | ((code_point >> 6) & 0x3F));
+			s->push_back(0x80 | (code_point & 0x3F));
+		}
+	}
+	
+	unsigned ParseHex4()
+	{
+		unsigned value = 0;
+		for (int k = 0; k < 4; ++k)
+		{
+			int c = Next();
+			if (!isxdigit(c)) Fail("invalid unicode escape");
+			value = value * 16 + (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+		}
+		return value;
+	}
+	
+	string ParseString()
+	{
+		Expect('"');
+		string s;
+		while (true)
+		{
+			int c = Next();
+			if (c == EOF) Fail("unterminated string");
+			if (c == '"') break;
+			if (c != '\\')
+			{
+				s.push_back(c);
+				continue;
+			}
+			c = Next();
+			if (c == '"' || c == '\\' || c == '/') s.push_back(c);
+			else if (c == 'b') s.push_back('\b');
+			else if (c == 'f') s.push_back('\f');
+			else if (c == 'n') s.push_back('\n');
+			else if (c == 'r') s.push_back('\r');
+			else if (c == 't') s.push_back('\t');
+			else if (c == 'u')
+			{
+				unsigned code_point = ParseHex4();
+				// Surrogate pairs encode the code points outside the basic multilingual plane.
+				if (code_point >= 0xD800 && code_point < 0xDC00)
+				{
+					Expect('\\');
+					Expect('u');
+					unsigned low = ParseHex4();
+					if (low < 0xDC00 || low >= 0xE000) Fail("invalid surrogate pair");
+					code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+				}
+				AppendUTF8(code_point, &s);
+			}
+			else Fail("invalid escape sequence");
+		}
+		return s;
+	}
+};
+}
+
+void JSONHandler::Integer(long long value)
+{
+	Number(value);
+}
+
+bool JSONDocumentBuilder::Done() const
+{
+	return done_;
+}
+
+void JSONDocumentBuilder::Null()
+{
+	Add(nullptr);
+}
+
+void JSONDocumentBuilder::Boolean(bool value)
+{
+	Add(value);
+}
+
+void JSONDocumentBuilder::Number(double value)
+{
+	Add(value);
+}
+
+void JSONDocumentBuilder::Integer(long long value)
+{
+	Add(value);
+}
+
+void JSONDocumentBuilder::String(const string& value)
+{
+	Add(value);
+}
+
+void JSONDocumentBuilder::StartObject()
+{
+	stack_.push_back(Add(json::object()));
+}
+
+void JSONDocumentBuilder::Key(const string& key)
+{
+	key_ = key;
+}
+
+void JSONDocumentBuilder::EndObject()
+{
+	stack_.pop_back();
+	done_ = stack_.empty();
+}
+
+void JSONDocumentBuilder::StartArray()
+{
+	stack_.push_back(Add(json::array()));
+}
+
+void JSONDocumentBuilder::EndArray()
+{
+	stack_.pop_back();
+	done_ = stack_.empty();
+}
+
+json* JSONDocumentBuilder::Add(const json& value)
+{
+	if (stack_.empty())
+	{
+		document = value;
+		done_ = !value.is_structured();
+		return &document;
+	}
+	json& container = *stack_.back();
+	if (container.is_object()) return &(container[key_] = value);
+	container.push_back(value);
+	return &container.back();
+}
+
+void parse_json_stream(istream& is, JSONHandler* handler)
+{
+	StreamParser parser(is, handler);
+	parser.ParseValue();
+}
+} // namespace goc
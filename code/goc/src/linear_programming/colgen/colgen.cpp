@@ -6,6 +6,7 @@
 
 #include "goc/linear_programming/colgen/colgen.h"
 
+#include "goc/collection/collection_utils.h"
 #include "goc/lib/json.hpp"
 #include "goc/time/duration.h"
 #include "goc/time/stopwatch.h"
@@ -36,7 +37,12 @@ CGExecutionLog solve_colgen(Formulation* formulation,
 				   Duration time_limit,
 				   const PricingFunction& pricing_function,
 				   LPSolver* lp_solver,
-				   const unordered_set<CGOption>& option)
+				   const unordered_set<CGOption>& option,
+				   CGStabilization stabilization,
+				   double smoothing_factor,
+				   double column_sum_bound,
+				   double cutoff,
+				   double gap_tolerance)
 {
 	Stopwatch rolex(true);
 	
@@ -46,6 +52,7 @@ CGExecutionLog solve_colgen(Formulation* formulation,
 	if (!execution_log.pricing_time.IsSet()) execution_log.pricing_time = 0.0_sec;
 	if (!execution_log.iterations.IsSet()) execution_log.iterations = vector<json>{};
 	if (!execution_log.iteration_count.IsSet()) execution_log.iteration_count = 0;
+	if (!execution_log.mispricing_count.IsSet()) execution_log.mispricing_count = 0;
 	
 	execution_log.status = CGStatus::Optimum;
 	
@@ -57,6 +64,19 @@ CGExecutionLog solve_colgen(Formulation* formulation,
 	int row_count = -1;
 	output.WriteHeader();
 	double objective_value = 0.0;
+	vector<double> center; // point kept by the stabilization (stability center or in-point).
+	bool gap_closed = false; // if the Lagrangian bound closed the gap before the pricing stopped finding columns.
+	
+	// Stores the Lagrangian bound L(pi) = pi * b + K * min(min_rc, 0) of some duals pi if it improves the best one.
+	// Returns: if the bound improved.
+	// Observation: min_rc is only valid for the rows that the duals were computed for.
+	auto improve_bound = [&] (double dual_value, double min_rc) {
+		if (column_sum_bound == INFTY || min_rc == -INFTY || row_count != formulation->ConstraintCount()) return false;
+		double lagrangian_bound = dual_value + column_sum_bound * min(min_rc, 0.0);
+		if (execution_log.lagrangian_bound.IsSet() && lagrangian_bound <= *execution_log.lagrangian_bound) return false;
+		execution_log.lagrangian_bound = lagrangian_bound;
+		return true;
+	};
 	while (variable_count < formulation->VariableCount() || row_count < formulation->ConstraintCount())
 	{
 		// Check if time limit was exceeded.
@@ -77,8 +97,61 @@ CGExecutionLog solve_colgen(Formulation* formulation,
 		
 		// Solve the pricing problem (i.e. add new variables to the formulation).
 		Stopwatch pricing_rolex(true);
-		pricing_function(*lp_log.duals, *lp_log.incumbent_value, time_limit - rolex.Peek(), &execution_log);
+		const vector<double>& duals = *lp_log.duals;
+		double min_reduced_cost = -INFTY; // lower bound on the reduced costs for the duals of the master.
+		bool priced = true; // if the duals of the master were priced.
+		if (stabilization == CGStabilization::None || center.size() != duals.size())
+		{
+			// No stabilization, or the rows changed and the stabilization starts again from the duals.
+			min_reduced_cost = pricing_function(duals, *lp_log.incumbent_value, time_limit - rolex.Peek(), &execution_log);
+			center = duals;
+		}
+		else
+		{
+			vector<double> stabilized_duals(duals.size());
+			for (int i = 0; i < duals.size(); ++i)
+				stabilized_duals[i] = smoothing_factor * center[i] + (1.0 - smoothing_factor) * duals[i];
+			execution_log.stabilized_duals = true;
+			double stabilized_min_rc = pricing_function(stabilized_duals, *lp_log.incumbent_value, time_limit - rolex.Peek(), &execution_log);
+			execution_log.stabilized_duals = false;
+			bool mispricing = variable_count == formulation->VariableCount();
+			if (mispricing) (*execution_log.mispricing_count)++;
+			
+			// Wentges: the stability center moves to the stabilized duals only if they improve the Lagrangian bound.
+			if (column_sum_bound < INFTY && stabilized_min_rc > -INFTY)
+			{
+				double dual_value = 0.0; // pi_s * b.
+				for (int i = 0; i < stabilized_duals.size(); ++i)
+					dual_value += stabilized_duals[i] * formulation->GetConstraintRightHandSide(i);
+				if (improve_bound(dual_value, stabilized_min_rc) && stabilization == CGStabilization::Wentges)
+					center = stabilized_duals;
+			}
+			if (stabilization == CGStabilization::InOut && mispricing) center = stabilized_duals;
+			
+			// Mispricing: fall back to the true duals, the column generation only finishes if they do not add columns.
+			// If the pricing function added rows, the true duals are outdated and the next iteration starts again.
+			priced = !mispricing || row_count != formulation->ConstraintCount();
+			if (!priced && rolex.Peek() < time_limit)
+			{
+				min_reduced_cost = pricing_function(duals, *lp_log.incumbent_value, time_limit - rolex.Peek(), &execution_log);
+				priced = true;
+			}
+		}
 		*execution_log.pricing_time += pricing_rolex.Pause();
+		
+		// The time limit was reached before the duals of the master were priced, so the master value is not a bound.
+		if (!priced) { execution_log.status = CGStatus::TimeLimitReached; break; }
+		
+		// Lagrangian bound z_LP + K * min_rc of the duals of the master.
+		if (improve_bound(objective_value, min_reduced_cost) && stabilization == CGStabilization::Wentges) center = duals;
+		
+		// The bound closes the node or the gap. If the pricing function added rows, the master changed after the bound
+		// was computed and it must be priced again.
+		if (execution_log.lagrangian_bound.IsSet() && row_count == formulation->ConstraintCount())
+		{
+			if (epsilon_bigger(*execution_log.lagrangian_bound, cutoff)) { execution_log.status = CGStatus::Cutoff; break; }
+			if (objective_value - *execution_log.lagrangian_bound <= gap_tolerance) { gap_closed = true; break; }
+		}
 	}
 	output.WriteRow({STR(rolex.Peek()), STR(execution_log.iteration_count), STR(objective_value), STR(formulation->VariableCount())});
 	if (screen_output) *screen_output << endl;
@@ -87,9 +160,15 @@ CGExecutionLog solve_colgen(Formulation* formulation,
 	if (*execution_log.status == CGStatus::Optimum)
 	{
 		lp_solver->time_limit = Duration::Max();
-		auto lp_log = lp_solver->Solve(formulation, {LPOption::Incumbent});
+		unordered_set<LPOption> lp_options = {LPOption::Incumbent};
+		if (includes(option, CGOption::Basis)) lp_options.insert(LPOption::Basis);
+		auto lp_log = lp_solver->Solve(formulation, lp_options);
 		execution_log.incumbent_value = lp_log.incumbent_value;
 		execution_log.incumbent = lp_log.incumbent;
+		if (lp_log.basis.IsSet()) execution_log.basis = lp_log.basis;
+		
+		// If no column prices out, the master value is the best bound.
+		if (!gap_closed) execution_log.lagrangian_bound = lp_log.incumbent_value;
 	}
 	execution_log.columns_added = formulation->VariableCount() - initial_variable_count;
 	execution_log.time = rolex.Peek();
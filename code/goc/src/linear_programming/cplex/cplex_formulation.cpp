@@ -59,11 +59,15 @@ CplexFormulation::CplexFormulation()
 	});
 	env_ = env_memory_handler_.get();
 	problem_ = cplex::createprob(env_, "formulation");
+	integer_problem_ = nullptr;
+	integer_active_ = false;
+	integer_column_count_ = -1;
 }
 
 CplexFormulation::~CplexFormulation()
 {
 	cplex::freeprob(env_, &problem_);
+	if (integer_problem_) cplex::freeprob(env_, &integer_problem_);
 	for (int* i: variable_indices_) delete i;
 }
 
@@ -71,14 +75,47 @@ int CplexFormulation::AddConstraint(const Constraint& constraint)
 {
 	// Add constraint to CPLEX formulation.
 	auto cplex_row = constraint_to_cplex_row(constraint);
+	InvalidateIntegerProblem();
 	cplex::addrows(env_, problem_, 0, 1, cplex_row.nzind, &cplex_row.rhs, &cplex_row.sense, &cplex_row.rmatbeg[0], &cplex_row.rmatind[0], &cplex_row.rmatval[0], nullptr, nullptr);
 	
 	return ConstraintCount()-1;
 }
 
+int CplexFormulation::AddRows(const vector<Row>& rows)
+{
+	int first = ConstraintCount();
+	if (rows.empty()) return first;
+	
+	// Build the rows in CSR format.
+	map<enum Constraint::Sense, char> cplex_senses = {{Constraint::LessEqual, 'L'}, {Constraint::GreaterEqual, 'G'},
+													  {Constraint::Equality, 'E'}};
+	vector<double> rhs, rmatval;
+	vector<int> rmatbeg, rmatind;
+	vector<char> sense;
+	for (auto& row: rows)
+	{
+		rhs.push_back(row.right_hand_side);
+		sense.push_back(cplex_senses[row.sense]);
+		rmatbeg.push_back(rmatind.size());
+		for (auto& coefficient: row.coefficients)
+		{
+			rmatind.push_back(coefficient.first);
+			rmatval.push_back(coefficient.second);
+		}
+	}
+	
+	// Add constraints to CPLEX.
+	InvalidateIntegerProblem();
+	cplex::addrows(env_, problem_, 0, rows.size(), rmatind.size(), rhs.data(), sense.data(), rmatbeg.data(),
+		rmatind.data(), rmatval.data(), nullptr, nullptr);
+	
+	return first;
+}
+
 void CplexFormulation::RemoveConstraint(int constraint_index)
 {
 	// Remove constraint from CPLEX.
+	InvalidateIntegerProblem();
 	cplex::delrows(env_, problem_, constraint_index, constraint_index);
 	
 	// Reduce all constraints indices following 'constraint_id' by one.
@@ -94,60 +131,113 @@ void CplexFormulation::RemoveConstraint(int constraint_index)
 void CplexFormulation::AddLazyConstraint(SeparationRoutine* lazy_constraint)
 {
 	if (!lazy_constraint) return;
+	InvalidateIntegerProblem();
 	lazy_constraints_.push_back(lazy_constraint);
 }
 
 void CplexFormulation::RemoveLazyConstraint(SeparationRoutine* lazy_constraint)
 {
 	if (!lazy_constraint) return;
+	InvalidateIntegerProblem();
 	lazy_constraints_.erase(remove(lazy_constraints_.begin(), lazy_constraints_.end(), lazy_constraint));
 }
 
 Variable CplexFormulation::AddVariable(const string& name, VariableDomain domain, double lower_bound, double upper_bound)
 {
-	// Add variable to internal structure.
-	variable_indices_.push_back(new int(variable_indices_.size()));
-	variable_names_.push_back(name);
-	
-	// Add variable to CPLEX.
-	char* colname[] = {(char*)variable_names_.back().c_str()};
-	cplex::newcols(env_, problem_, 1, nullptr, nullptr, nullptr, nullptr, colname);
+	return AddColumns({Column{name, domain, lower_bound, upper_bound, 0.0, {}}})[0];
+}
+
+vector<Variable> CplexFormulation::AddColumns(const vector<Column>& columns)
+{
+	if (columns.empty()) return {};
 	
-	Variable var(name, variable_indices_.back());
+	// Add variables to internal structure.
+	int first = variable_indices_.size();
+	for (auto& column: columns)
+	{
+		variable_indices_.push_back(new int(variable_indices_.size()));
+		variable_names_.push_back(column.name);
+		variable_domains_.push_back(column.domain);
+	}
 	
-	// Set variable domain.
-	SetVariableDomain(var, domain);
+	// Build the columns in CSC format.
+	vector<double> obj, lb, ub, cmatval;
+	vector<int> cmatbeg, cmatind;
+	vector<char*> colname;
+	for (int k = 0; k < columns.size(); ++k)
+	{
+		auto& column = columns[k];
+		obj.push_back(column.objective_coefficient);
+		lb.push_back(column.lower_bound == -INFTY ? -CPX_INFBOUND : column.lower_bound);
+		ub.push_back(column.upper_bound == INFTY ? CPX_INFBOUND : column.upper_bound);
+		cmatbeg.push_back(cmatind.size());
+		for (auto& coefficient: column.coefficients)
+		{
+			cmatind.push_back(coefficient.first);
+			cmatval.push_back(coefficient.second);
+		}
+		colname.push_back((char*)variable_names_[first + k].c_str());
+	}
 	
-	// Set bounds.
-	SetVariableBound(var, lower_bound, upper_bound);
+	// Add variables to CPLEX (their domains are only set in the MILP copy).
+	cplex::addcols(env_, problem_, columns.size(), cmatind.size(), obj.data(), cmatbeg.data(), cmatind.data(),
+		cmatval.data(), lb.data(), ub.data(), colname.data());
 	
-	return var;
+	vector<Variable> variables;
+	for (int k = 0; k < columns.size(); ++k) variables.push_back(Variable(columns[k].name, variable_indices_[first + k]));
+	return variables;
 }
 
 void CplexFormulation::RemoveVariable(const Variable& variable)
 {
 	// Remove variable from CPLEX.
+	InvalidateIntegerProblem();
 	cplex::delcols(env_, problem_, variable.Index(), variable.Index());
 	
 	// Reduce all variable indices following the erased variable by one and delete its name from the vector of names.
 	for (int i = variable.Index(); i < variable_indices_.size()-1; ++i)
 	{
 		swap(variable_names_[i], variable_names_[i+1]);
+		swap(variable_domains_[i], variable_domains_[i+1]);
 		swap(variable_indices_[i], variable_indices_[i+1]);
 		*variable_indices_[i] = i;
 	}
 	variable_names_.pop_back();
+	variable_domains_.pop_back();
 	delete variable_indices_.back();
 	variable_indices_.pop_back();
 }
 
+void CplexFormulation::RemoveVariables(const vector<Variable>& variables)
+{
+	if (variables.empty()) return;
+	
+	// Remove variables from CPLEX.
+	vector<int> delstat(VariableCount(), 0);
+	for (auto& variable: variables) delstat[variable.Index()] = 1;
+	InvalidateIntegerProblem();
+	cplex::delsetcols(env_, problem_, delstat.data());
+	
+	// Compact the indices and names of the remaining variables, and delete the indices of the removed ones.
+	int k = 0;
+	for (int i = 0; i < variable_indices_.size(); ++i)
+	{
+		if (delstat[i]) { delete variable_indices_[i]; continue; }
+		swap(variable_names_[k], variable_names_[i]);
+		variable_domains_[k] = variable_domains_[i];
+		variable_indices_[k] = variable_indices_[i];
+		*variable_indices_[k] = k;
+		++k;
+	}
+	variable_names_.resize(k);
+	variable_domains_.resize(k);
+	variable_indices_.resize(k);
+}
+
 void CplexFormulation::SetVariableDomain(const Variable& variable, VariableDomain domain)
 {
-	std::map<VariableDomain, char> cplex_domains = {{VariableDomain::Real, 'C'}, {VariableDomain::Integer, 'I'},
-													{VariableDomain::Binary, 'B'}};
-	int indices[] = {variable.Index()};
-	char xctype[] = {cplex_domains[domain]};
-	cplex::chgctype(env_, problem_, 1, indices, xctype);
+	InvalidateIntegerProblem();
+	variable_domains_[variable.Index()] = domain;
 }
 
 void CplexFormulation::SetVariableBound(const Variable& v, double lower_bound, double upper_bound)
@@ -157,7 +247,31 @@ void CplexFormulation::SetVariableBound(const Variable& v, double lower_bound, d
 	int indices[] = {v.Index(), v.Index()};
 	double bd[] = {lower_bound, upper_bound};
 	char type[] = {'L', 'U'};
-	cplex::chgbds(env_, problem_, 2, indices, type, bd);
+	ChangeBounds(2, indices, type, bd);
+}
+
+void CplexFormulation::SetVariableBounds(const vector<Variable>& variables, double lower_bound, double upper_bound)
+{
+	SetVariableBounds(variables, vector<double>(variables.size(), lower_bound),
+		vector<double>(variables.size(), upper_bound));
+}
+
+void CplexFormulation::SetVariableBounds(const vector<Variable>& variables, const vector<double>& lower_bounds,
+	const vector<double>& upper_bounds)
+{
+	if (variables.empty()) return;
+	vector<int> indices;
+	vector<double> bd;
+	vector<char> type;
+	for (int k = 0; k < variables.size(); ++k)
+	{
+		double lower_bound = lower_bounds[k] == -INFTY ? -CPX_INFBOUND : lower_bounds[k];
+		double upper_bound = upper_bounds[k] == INFTY ? CPX_INFBOUND : upper_bounds[k];
+		indices.insert(indices.end(), {variables[k].Index(), variables[k].Index()});
+		bd.insert(bd.end(), {lower_bound, upper_bound});
+		type.insert(type.end(), {'L', 'U'});
+	}
+	ChangeBounds(indices.size(), indices.data(), type.data(), bd.data());
 }
 
 void CplexFormulation::SetVariableLowerBound(const Variable& v, double lower_bound)
@@ -166,7 +280,7 @@ void CplexFormulation::SetVariableLowerBound(const Variable& v, double lower_bou
 	int indices[] = {v.Index()};
 	double bd[] = {lower_bound};
 	char type[] = {'L'};
-	cplex::chgbds(env_, problem_, 1, indices, type, bd);
+	ChangeBounds(1, indices, type, bd);
 }
 
 void CplexFormulation::SetVariableUpperBound(const Variable& v, double upper_bound)
@@ -175,7 +289,7 @@ void CplexFormulation::SetVariableUpperBound(const Variable& v, double upper_bou
 	int indices[] = {v.Index()};
 	double bd[] = {upper_bound};
 	char type[] = {'U'};
-	cplex::chgbds(env_, problem_, 1, indices, type, bd);
+	ChangeBounds(1, indices, type, bd);
 }
 
 void CplexFormulation::Minimize(const Expression& objective_function)
@@ -188,6 +302,7 @@ void CplexFormulation::Minimize(const Expression& objective_function)
 		values[term.first.Index()] = term.second;
 		++i;
 	}
+	InvalidateIntegerProblem();
 	cplex::chgobj(env_, problem_, VariableCount(), &indices[0], &values[0]);
 	cplex::chgobjsen(env_, problem_, CPX_MIN);
 }
@@ -202,23 +317,27 @@ void CplexFormulation::Maximize(const Expression& objective_function)
 		values[term.first.Index()] = term.second;
 		++i;
 	}
+	InvalidateIntegerProblem();
 	cplex::chgobj(env_, problem_, VariableCount(), &indices[0], &values[0]);
 	cplex::chgobjsen(env_, problem_, CPX_MAX);
 }
 
 void CplexFormulation::SetConstraintRightHandSide(int constraint_index, double value)
 {
+	InvalidateIntegerProblem();
 	cplex::chgrhs(env_, problem_, 1, &constraint_index, &value);
 }
 
 void CplexFormulation::SetConstraintCoefficient(int constraint_index, const Variable& variable, double coefficient)
 {
+	InvalidateIntegerProblem();
 	cplex::chgcoef(env_, problem_, constraint_index, variable.Index(), coefficient);
 }
 
 void CplexFormulation::SetObjectiveCoefficient(const Variable& variable, double coefficient)
 {
 	int indices[] = {variable.Index()};
+	InvalidateIntegerProblem();
 	cplex::chgobj(env_, problem_, 1, indices, &coefficient);
 }
 
@@ -250,12 +369,7 @@ double CplexFormulation::GetConstraintCoefficient(int constraint_index, const Va
 
 VariableDomain CplexFormulation::GetVariableDomain(const Variable& variable) const
 {
-	char type;
-	cplex::getctype(env_, problem_, &type, variable.Index(), variable.Index());
-	
-	std::map<char, VariableDomain> cplex_domains = {{'C', VariableDomain::Real}, {'I', VariableDomain::Integer},
-													{'B', VariableDomain::Binary}};
-	return cplex_domains[type];
+	return variable_domains_[variable.Index()];
 }
 
 pair<double, double> CplexFormulation::GetVariableBound(const Variable& variable) const
@@ -353,10 +467,24 @@ bool CplexFormulation::IsFeasibleValuation(const Valuation& v, bool verbose) con
 	return true;
 }
 
+void CplexFormulation::SetBasis(const Basis& basis)
+{
+	basis_ = basis;
+}
+
+Basis CplexFormulation::ExtractBasis()
+{
+	Basis basis;
+	swap(basis, basis_);
+	return basis;
+}
+
 Formulation* CplexFormulation::Copy() const
 {
-	CplexFormulation* copy = new CplexFormulation(env_memory_handler_, cplex::cloneprob(env_, problem_));
+	CPXLPptr linear_problem = integer_active_ ? integer_problem_ : problem_;
+	CplexFormulation* copy = new CplexFormulation(env_memory_handler_, cplex::cloneprob(env_, linear_problem));
 	copy->variable_names_ = variable_names_;
+	copy->variable_domains_ = variable_domains_;
 	for (int i = 0; i < VariableCount(); ++i) copy->variable_indices_.push_back(new int(i));
 	for (int i = 0; i < ConstraintCount(); ++i) copy->constraint_indices_.push_back(new int(i));
 	copy->lazy_constraints_ = lazy_constraints_;
@@ -383,8 +511,89 @@ CPXLPptr CplexFormulation::Problem() const
 	return problem_;
 }
 
+void CplexFormulation::SwitchToIntegerProblem()
+{
+	if (integer_active_) return;
+	
+	// Create the MILP copy if it does not exist or it is outdated.
+	if (integer_column_count_ == -1)
+	{
+		if (integer_problem_) cplex::freeprob(env_, &integer_problem_);
+		integer_problem_ = cplex::cloneprob(env_, problem_);
+		cplex::chgprobtype(env_, integer_problem_, CPXPROB_MILP);
+		integer_column_count_ = 0;
+	}
+	// Otherwise, append the columns added since the last call (one by one, to bound the space of their coefficients).
+	else
+	{
+		int m = ConstraintCount(), nzcnt, surplus;
+		vector<int> cmatbeg(1), cmatind(max(m, 1));
+		vector<double> cmatval(max(m, 1));
+		for (int j = integer_column_count_; j < VariableCount(); ++j)
+		{
+			double obj, lb, ub;
+			cplex::getcols(env_, problem_, &nzcnt, cmatbeg.data(), cmatind.data(), cmatval.data(), m, &surplus, j, j);
+			cplex::getobj(env_, problem_, &obj, j, j);
+			cplex::getlb(env_, problem_, &lb, j, j);
+			cplex::getub(env_, problem_, &ub, j, j);
+			char* colname[] = {(char*)variable_names_[j].c_str()};
+			cplex::addcols(env_, integer_problem_, 1, nzcnt, &obj, cmatbeg.data(), cmatind.data(), cmatval.data(), &lb,
+				&ub, colname);
+		}
+	}
+	
+	// Set the domains of the new columns with a single call.
+	map<VariableDomain, char> cplex_domains = {{VariableDomain::Real, 'C'}, {VariableDomain::Integer, 'I'},
+											   {VariableDomain::Binary, 'B'}};
+	vector<int> indices;
+	vector<char> xctype;
+	for (int j = integer_column_count_; j < VariableCount(); ++j)
+	{
+		indices.push_back(j);
+		xctype.push_back(cplex_domains[variable_domains_[j]]);
+	}
+	if (!indices.empty()) cplex::chgctype(env_, integer_problem_, indices.size(), indices.data(), xctype.data());
+	integer_column_count_ = VariableCount();
+	
+	swap(problem_, integer_problem_);
+	integer_active_ = true;
+}
+
+void CplexFormulation::SwitchToLinearProblem()
+{
+	if (!integer_active_) return;
+	swap(problem_, integer_problem_);
+	integer_active_ = false;
+}
+
+void CplexFormulation::InvalidateIntegerProblem()
+{
+	integer_column_count_ = -1;
+}
+
+void CplexFormulation::ChangeBounds(int count, const int* indices, const char* type, const double* bd)
+{
+	cplex::chgbds(env_, problem_, count, indices, type, bd);
+	
+	// The columns not yet in the MILP copy get their bounds when they are appended.
+	if (integer_active_ || integer_column_count_ == -1) return;
+	vector<int> copy_indices;
+	vector<char> copy_type;
+	vector<double> copy_bd;
+	for (int k = 0; k < count; ++k)
+	{
+		if (indices[k] >= integer_column_count_) continue;
+		copy_indices.push_back(indices[k]);
+		copy_type.push_back(type[k]);
+		copy_bd.push_back(bd[k]);
+	}
+	if (!copy_indices.empty())
+		cplex::chgbds(env_, integer_problem_, copy_indices.size(), copy_indices.data(), copy_type.data(), copy_bd.data());
+}
+
 CplexFormulation::CplexFormulation(const std::shared_ptr<cpxenv>& env_memory_handler, CPXLPptr problem)
-	: env_memory_handler_(env_memory_handler), env_(env_memory_handler.get()), problem_(problem)
+	: env_memory_handler_(env_memory_handler), env_(env_memory_handler.get()), problem_(problem),
+	  integer_problem_(nullptr), integer_active_(false), integer_column_count_(-1)
 {
 
 }
@@ -4,6 +4,7 @@
 // Departamento de Computacion - Universidad de Buenos Aires.
 //
 
+#include <map>
 #include <mutex>
 
 #include "goc/collection/collection_utils.h"
@@ -25,6 +26,12 @@ namespace cplex
 {
 namespace
 {
+// Mappings between the CPLEX basis statuses and the goc ones.
+const map<int, Basis::Status> cplex_to_basis_status = {{CPX_AT_LOWER, Basis::AtLower}, {CPX_BASIC, Basis::Basic},
+	{CPX_AT_UPPER, Basis::AtUpper}, {CPX_FREE_SUPER, Basis::FreeSuperbasic}};
+const map<Basis::Status, int> basis_to_cplex_status = {{Basis::AtLower, CPX_AT_LOWER}, {Basis::Basic, CPX_BASIC},
+	{Basis::AtUpper, CPX_AT_UPPER}, {Basis::FreeSuperbasic, CPX_FREE_SUPER}};
+
 // Function that gets called by cplex when a message is sent to the log.
 void tunnel_message(void* handle, const char* message)
 {
@@ -185,6 +192,32 @@ void extract_cplex_lp_execution_info(CplexFormulation* formulation, LPExecutionL
 		cplex::getpi(env, prob, &(duals[0]), 0, formulation->ConstraintCount() - 1);
 		execution_log->duals = duals;
 	}
+	
+	// Basis.
+	if (includes(options, LPOption::Basis) && execution_log->status == LPStatus::Optimum)
+	{
+		vector<int> cstat(formulation->VariableCount()), rstat(formulation->ConstraintCount());
+		cplex::getbase(env, prob, cstat.data(), rstat.data());
+		Basis basis;
+		for (int s: cstat) basis.variable_status.push_back(cplex_to_basis_status.at(s));
+		for (int s: rstat) basis.constraint_status.push_back(cplex_to_basis_status.at(s));
+		execution_log->basis = basis;
+	}
+}
+
+// Warm starts the next relaxation from the basis set in the formulation (if any).
+// Variables added after the basis was taken are nonbasic at their lower bound, and the slacks of the constraints added
+// are basic, so the number of basic variables is still the number of constraints.
+// Precondition: the problem type has already been changed to LP (changing the problem type may discard the basis).
+void apply_basis(CplexFormulation* formulation)
+{
+	Basis basis = formulation->ExtractBasis();
+	int n = formulation->VariableCount(), m = formulation->ConstraintCount();
+	if (basis.IsEmpty() || basis.variable_status.size() > n || basis.constraint_status.size() > m) return;
+	vector<int> cstat(n, CPX_AT_LOWER), rstat(m, CPX_BASIC);
+	for (int i = 0; i < basis.variable_status.size(); ++i) cstat[i] = basis_to_cplex_status.at(basis.variable_status[i]);
+	for (int i = 0; i < basis.constraint_status.size(); ++i) rstat[i] = basis_to_cplex_status.at(basis.constraint_status[i]);
+	cplex::copybase(formulation->Environment(), formulation->Problem(), cstat.data(), rstat.data());
 }
 
 // Extract information about the execution of CPLEX after solving with mipopt and add it to the execution log if necessary.
@@ -455,12 +488,10 @@ LPExecutionLog solve_lp(CplexFormulation* formulation, ostream* screen_output, D
 	cplex::setdblparam(formulation->Environment(), CPX_PARAM_TILIM, max(0.0, time_limit.Amount(DurationUnit::Seconds)));
 	cplex::setintparam(formulation->Environment(), CPX_PARAM_REDUCE, CPX_PREREDUCE_NOPRIMALORDUAL);
 	
-	// Change problem to LP, but before save the domain of variables, because changing the problem type to LP erases
-	// them.
-	vector<VariableDomain> variable_domains(formulation->VariableCount());
-	for (int i = 0; i < formulation->VariableCount(); ++i)
-		variable_domains[i] = formulation->GetVariableDomain(formulation->VariableAtIndex(i));
-	cplex::chgprobtype(formulation->Environment(), formulation->Problem(), CPXPROB_LP);
+	// The problem of the formulation is always an LP (the variable domains are only set in its MILP copy).
+	
+	// Warm start from the basis set in the formulation (if any).
+	apply_basis(formulation);
 	
 	// Optimize.
 	Stopwatch rolex(true);
@@ -475,10 +506,6 @@ LPExecutionLog solve_lp(CplexFormulation* formulation, ostream* screen_output, D
 	if (includes(options, LPOption::ScreenOutput)) execution_log.screen_output = log_stream.str();
 	extract_cplex_lp_execution_info(formulation, &execution_log, options);
 	
-	// Return the variable domain to all variables.
-	for (int i = 0; i < formulation->VariableCount(); ++i)
-		formulation->SetVariableDomain(formulation->VariableAtIndex(i), variable_domains[i]);
-	
 	return execution_log;
 }
 
@@ -488,6 +515,9 @@ BCExecutionLog solve_bc(CplexFormulation* formulation, ostream* screen_output, D
 {
 	BCExecutionLog execution_log;
 	
+	// Solve the MILP copy of the formulation, which only needs to be created (or extended) here.
+	formulation->SwitchToIntegerProblem();
+	
 	// Tunnel CPLEX logs to the screen and to the log stream if requested.
 	vector<ostream*> output_streams;
 	stringstream log_stream;
@@ -520,9 +550,6 @@ BCExecutionLog solve_bc(CplexFormulation* formulation, ostream* screen_output, D
 	// Apply time limit.
 	cplex::setdblparam(formulation->Environment(), CPX_PARAM_TILIM, max(0.0, time_limit.Amount(DurationUnit::Seconds)));
 	
-	// Set problem type to integer and set all variable domains.
-	cplex::chgprobtype(formulation->Environment(), formulation->Problem(), CPXPROB_MILP);
-	
 	// Add initial solutions.
 	add_initial_solutions(formulation, initial_solutions);
 	
@@ -563,6 +590,9 @@ BCExecutionLog solve_bc(CplexFormulation* formulation, ostream* screen_output, D
 		}
 	}
 	
+	// Keep solving the linear relaxations on the LP problem.
+	formulation->SwitchToLinearProblem();
+	
 	return execution_log;
 }
 } // namespace cplex
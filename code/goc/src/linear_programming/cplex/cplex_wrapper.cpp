@@ -98,6 +98,16 @@ newcols(CPXENVptr env, CPXLPptr lp, int ccnt, double const* obj, double const* l
 	}
 }
 
+void addcols(CPXENVptr env, CPXLPptr lp, int ccnt, int nzcnt, double const* obj, int const* cmatbeg,
+			 int const* cmatind, double const* cmatval, double const* lb, double const* ub, char** colname)
+{
+	int status = CPXaddcols(env, lp, ccnt, nzcnt, obj, cmatbeg, cmatind, cmatval, lb, ub, colname);
+	if (status != 0)
+	{
+		fail_with_error_message(env, status, "CPXaddcols");
+	}
+}
+
 void delcols(CPXCENVptr env, CPXLPptr lp, int begin, int end)
 {
 	int status = CPXdelcols(env, lp, begin, end);
@@ -107,6 +117,15 @@ void delcols(CPXCENVptr env, CPXLPptr lp, int begin, int end)
 	}
 }
 
+void delsetcols(CPXCENVptr env, CPXLPptr lp, int* delstat)
+{
+	int status = CPXdelsetcols(env, lp, delstat);
+	if (status != 0)
+	{
+		fail_with_error_message(env, status, "CPXdelsetcols");
+	}
+}
+
 void chgctype(CPXENVptr env, CPXLPptr lp, int cnt, int const* indices, char const* xctype)
 {
 	int status = CPXchgctype(env, lp, cnt, indices, xctype);
@@ -368,6 +387,16 @@ void getrows(CPXCENVptr env, CPXCLPptr lp, int* nzcnt_p, int* rmatbeg, int* rmat
 	}
 }
 
+void getcols(CPXCENVptr env, CPXCLPptr lp, int* nzcnt_p, int* cmatbeg, int* cmatind, double* cmatval, int cmatspace,
+			 int* surplus_p, int begin, int end)
+{
+	int status = CPXgetcols(env, lp, nzcnt_p, cmatbeg, cmatind, cmatval, cmatspace, surplus_p, begin, end);
+	if (status != 0)
+	{
+		fail_with_error_message(env, status, "CPXgetcols");
+	}
+}
+
 void setintparam(CPXENVptr env, int whichparam, CPXINT newvalue)
 {
 	int status = CPXsetintparam(env, whichparam, newvalue);
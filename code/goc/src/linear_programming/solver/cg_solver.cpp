@@ -6,6 +6,9 @@
 
 #include "goc/linear_programming/solver/cg_solver.h"
 
+#include <unordered_map>
+
+#include "goc/exception/exception_utils.h"
 #include "goc/linear_programming/colgen/colgen.h"
 #include "goc/linear_programming/cplex/cplex_formulation.h"
 #include "goc/linear_programming/cplex/cplex_solver.h"
@@ -19,6 +22,10 @@ namespace goc
 namespace
 {
 LPSolver default_lp_solver;
+
+unordered_map<string, CGStabilization> stabilization_by_name = {{"None", CGStabilization::None},
+															  {"Wentges", CGStabilization::Wentges},
+															  {"InOut", CGStabilization::InOut}};
 }
 
 CGSolver::CGSolver()
@@ -27,15 +34,36 @@ CGSolver::CGSolver()
 	time_limit = Duration::Max();
 	lp_solver = &default_lp_solver;
 	screen_output = nullptr;
+	stabilization = CGStabilization::None;
+	smoothing_factor = 0.8;
+	column_sum_bound = INFTY;
+	cutoff = INFTY;
+	gap_tolerance = 0.0;
 }
 
 CGExecutionLog CGSolver::Solve(Formulation* formulation, const std::unordered_set<CGOption>& options) const
 {
-	return solve_colgen(formulation, screen_output, time_limit, pricing_function, lp_solver, options);
+	return solve_colgen(formulation, screen_output, time_limit, pricing_function, lp_solver, options, stabilization,
+		smoothing_factor, column_sum_bound, cutoff, gap_tolerance);
 }
 
 Formulation* CGSolver::NewFormulation()
 {
 	return default_lp_solver.NewFormulation();
 }
+
+ostream& operator<<(ostream& os, CGStabilization stabilization)
+{
+	for (auto& entry: stabilization_by_name)
+		if (entry.second == stabilization)
+			return os << entry.first;
+	return os;
+}
+
+void from_json(const json& j, CGStabilization& stabilization)
+{
+	string name = j;
+	if (stabilization_by_name.count(name) == 0) fail("Unknown column generation stabilization: " + name + ".");
+	stabilization = stabilization_by_name[name];
+}
 } // namespace goc
\ No newline at end of file
@@ -22,8 +22,10 @@ json CGExecutionLog::ToJSON() const
 	if (status.IsSet()) j["status"] = STR(status.Value());
 	if (incumbent.IsSet()) j["incumbent"] = incumbent.Value();
 	if (incumbent_value.IsSet()) j["incumbent_value"] = incumbent_value.Value();
+	if (lagrangian_bound.IsSet()) j["lagrangian_bound"] = lagrangian_bound.Value();
 	if (columns_added.IsSet()) j["columns_added"] = columns_added.Value();
 	if (iteration_count.IsSet()) j["iteration_count"] = iteration_count.Value();
+	if (mispricing_count.IsSet()) j["mispricing_count"] = mispricing_count.Value();
 	if (pricing_time.IsSet()) j["pricing_time"] = pricing_time.Value();
 	if (lp_time.IsSet()) j["lp_time"] = lp_time.Value();
 	if (iterations.IsSet())
@@ -42,6 +44,7 @@ ostream& operator<<(ostream& os, CGStatus status)
 											  {CGStatus::Unbounded, "Unbounded"},
 											  {CGStatus::TimeLimitReached, "TimeLimitReached"},
 											  {CGStatus::MemoryLimitReached, "MemoryLimitReached"},
+											  {CGStatus::Cutoff, "Cutoff"},
 											  {CGStatus::Optimum, "Optimum"}};
 	return os << mapper[status];
 }
@@ -279,6 +279,71 @@ PWLFunction PWLFunction::RestrictImage(const Interval& image) const
 	return f;
 }
 
+PWLFunction PWLFunction::Simplify(double tolerance) const
+{
+	bool non_decreasing = true;
+	for (int i = 0; i < PieceCount(); ++i)
+	{
+		const LinearFunction& p = pieces_[i];
+		if (!p.domain.IsPoint() && epsilon_smaller(p.slope, 0.0)) non_decreasing = false;
+		if (i > 0 && epsilon_smaller(p.Value(p.domain.left), pieces_[i-1].Value(pieces_[i-1].domain.right)))
+			non_decreasing = false;
+	}
+	
+	PWLFunction g;
+	int i = 0;
+	while (i < PieceCount())
+	{
+		// Breakpoints of the maximal continuous sequence of pieces i, ..., j-1.
+		vector<Point2D> P = {Point2D(pieces_[i].domain.left, pieces_[i].Value(pieces_[i].domain.left))};
+		int j = i;
+		for (; j < PieceCount(); ++j)
+		{
+			const LinearFunction& p = pieces_[j];
+			if (j > i)
+			{
+				const LinearFunction& q = pieces_[j-1];
+				if (epsilon_different(q.domain.right, p.domain.left)) break;
+				if (epsilon_different(q.Value(q.domain.right), p.Value(p.domain.left))) break;
+			}
+			if (!p.domain.IsPoint()) P.push_back(Point2D(p.domain.right, p.Value(p.domain.right)));
+		}
+		if (P.size() == 1)
+		{
+			for (int k = i; k < j; ++k) g.AddPiece(pieces_[k]);
+			i = j;
+			continue;
+		}
+		
+		// Each new piece starts at (P[s].x, y) with P[s].y <= y <= P[s].y + tolerance, and is extended to the last
+		// breakpoint P[e] such that some line lies between f and f + tolerance at P[s+1], ..., P[e] (hence in the whole
+		// segment). The lowest of those lines is taken, so the next piece starts as close to f as possible.
+		double y = P[0].y;
+		if (non_decreasing && !g.Empty()) y = max(y, g.LastPiece().Value(g.Domain().right));
+		for (int s = 0; s+1 < (int)P.size();)
+		{
+			double lo = -INFTY, hi = INFTY;
+			int e = s+1;
+			for (int k = s+1; k < (int)P.size(); ++k)
+			{
+				double dx = P[k].x - P[s].x;
+				double l = max(lo, (P[k].y - y) / dx), h = min(hi, (P[k].y + tolerance - y) / dx);
+				if (l > h) break;
+				lo = l;
+				hi = h;
+				e = k;
+			}
+			double slope = non_decreasing ? max(lo, 0.0) : lo;
+			double y_e = y + slope * (P[e].x - P[s].x);
+			g.AddPiece(LinearFunction(Point2D(P[s].x, y), Point2D(P[e].x, y_e)));
+			s = e;
+			y = y_e;
+		}
+		i = j;
+	}
+	return g;
+}
+
 void PWLFunction::Print(std::ostream& os) const
 {
 	os << "[";
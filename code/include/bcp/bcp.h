@@ -7,6 +7,12 @@
 #ifndef NETWORKS2019_BP_H
 #define NETWORKS2019_BP_H
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+
 #include "goc/goc.h"
 #include "vrp_instance.h"
 #include "pricing_problem.h"
@@ -14,7 +20,11 @@
 
 namespace networks2019
 {
-typedef std::function<void(const PricingProblem& pricing_problem, int node_number, goc::Duration time_limit, goc::CGExecutionLog* cg_execution_log)> BCPPricingFunction;
+// Function that solves the pricing problem and stores the negative reduced cost routes found in 'routes'.
+// Returns: a lower bound on the minimum reduced cost of the routes (-INFTY if it was not proven, e.g. by a heuristic).
+// - worker: index of the tree worker solving the node (in [0, tree_threads)). Calls with different workers may run
+//	concurrently, calls with the same worker never do.
+typedef std::function<double(const PricingProblem& pricing_problem, int node_number, int worker, goc::Duration time_limit, goc::CGExecutionLog* cg_execution_log, std::vector<goc::Route>* routes)> BCPPricingFunction;
 
 // This class represents a branch cut and price algorithm. It is a one use object.
 class BCP
@@ -23,14 +33,31 @@ public:
 	goc::Duration time_limit;
 	int node_limit;
 	int cut_limit;
+	int cuts_per_round; // maximum number of (vertex disjoint) cuts added in each separation round.
+	int separation_threads; // number of threads used to evaluate the candidate cuts.
+	int strong_branch_size; // maximum number of candidate arcs evaluated in strong branching.
+	int strong_branch_threads; // number of threads used to evaluate the strong branching candidates.
+	int tree_threads; // number of workers that process the nodes of the BB tree concurrently.
+	int column_age_limit; // columns not in the basis for this many consecutive CG iterations are moved to the pool.
+	goc::CGStabilization dual_stabilization; // dual stabilization used in the column generation of the nodes.
+	double smoothing_factor; // weight of the stability center (or in-point) in the stabilized duals.
+	double cg_gap_tolerance; // the CG of a node stops when its value is within this gap of the Lagrangian bound.
+	nlohmann::json lp_config; // CPLEX parameters for the relaxations of the nodes.
+	nlohmann::json root_lp_config; // CPLEX parameters for the relaxations of the root node (e.g. barrier or concurrent).
+	nlohmann::json mip_config; // CPLEX parameters for the MIP solved by the freeze heuristic.
 	BCPPricingFunction pricing_solver;
 	
 	// Initializes the Branch cut and price solver.
-	// 	D: digraph that the VRP is based on.
+	// 	vrp: shared instance that the VRP is based on.
 	//	spf: set-partitioning formulation to use (it must include an initial solution).
-	BCP(const goc::Digraph& D, SPF* spf);
+	BCP(std::shared_ptr<const VRPInstance> vrp, SPF* spf);
 	
 	// Executes a Branch-Cut-Price algorithm on
+	// Observation: the root node is processed sequentially on spf. If tree_threads > 1, the rest of the tree is processed
+	// by tree_threads workers, each one with its own clone of spf; spf is kept as the global pool of routes, the routes
+	// found by any worker are added to it and synced into the clone of the worker that found them.
+	// The threads used by the workers, the strong branching, the separation and CPLEX (only when its configuration sets
+	// CPX_PARAM_THREADS) are reserved from the process thread budget, so each part may get fewer than requested.
 	goc::BCPExecutionLog Run(goc::VRPSolution* solution);
 	
 private:
@@ -39,40 +66,72 @@ private:
 		int index;
 		double bound;
 		std::vector<goc::Arc> A; // forbidden arcs.
-		goc::Valuation opt; // relaxation optimum.
+		std::vector<std::pair<goc::Route, double>> opt; // routes with non-zero value in the relaxation optimum.
+		SPFBasis basis; // basis to warm start the relaxation: the parent optimal basis, and the node one once solved.
 		
 		struct Comparator { inline bool operator() (Node* n1, Node* n2) { return n1->bound > n2->bound; } };
 	};
 	
-	// Returns: an estimate of the node's bound.
+	// A worker processes nodes of the BB tree, solving their relaxations on its own SPF.
+	struct Worker
+	{
+		int index; // index of the worker (sent to the pricing solver).
+		SPF* spf; // relaxation solved by the worker.
+		std::unique_ptr<SPF> clone; // clone of the global pool owned by the worker (nullptr if spf is the global pool).
+		bool separate_cuts; // if cuts should be separated when the pricing does not find routes (only in the root).
+		goc::LPSolver lp_solver;
+		goc::CGSolver cg_solver;
+	};
+	
+	// Returns: a worker with the specified index that solves the relaxations on 'relaxation'.
+	// If owned, the worker takes ownership of the relaxation.
+	std::unique_ptr<Worker> CreateWorker(int index, SPF* relaxation, bool owned);
+	
+	// Adds the routes to the global pool, and syncs the worker SPF with it.
+	void AddRoutes(Worker* worker, const std::vector<goc::Route>& routes);
+	
+	// Pops and branches the nodes in the queue until it is empty (and no other worker is branching) or a limit is reached.
+	void ExploreTree(Worker* worker, goc::TableStream* tstream);
+	
+	// Returns: an estimate of the node's bound, solving the relaxation with the columns and cuts in 'relaxation'.
 	// If the node is infeasible or unbounded it returns INFTY.
-	double EstimateBound(Node* node);
+	double EstimateBound(Node* node, SPF* relaxation, const goc::LPSolver& solver);
 	
-	// Solves the node relaxation using CG and sets its bound and opt attributes.
+	// Solves the node relaxation using CG on the worker SPF and sets its bound and opt attributes.
 	// Adds it to the queue if it is feasible and fractional.
-	void ProcessNode(Node* node);
+	void ProcessNode(Node* node, Worker* worker);
 	
 	// Branches the node using strong branching.
-	void BranchNode(Node* node);
+	void BranchNode(Node* node, Worker* worker);
+	
+	// Makes the first k formulations in spf_pool have the same routes and cuts than spf, creating them if necessary.
+	void SyncPool(int k);
 	
 	// The freeze heuristic consists in solving the SPF with the existing columns using a BC solver.
 	// The best solution there is an UB to the problem.
 	void FreezeHeuristic();
 	
-	// Separates subset row cuts with n = 3, k = 2.
-	// Returns: if any cut was added.
-	bool SeparateCuts(const goc::Valuation& z);
+	// Separates subset row cuts with n = 3, k = 2. Only the triples where two vertices share a fractional route are
+	// evaluated, and up to k vertex disjoint cuts are added (the most violated first).
+	// Returns: the number of cuts added.
+	int SeparateCuts(const goc::Valuation& z, int k);
 	
 	std::priority_queue<Node*, std::vector<Node*>, Node::Comparator> q; // queue of nodes in the BB tree.
 	double z_ub, z_lb; // z_ub = value of the best int solution, z_lb = value of the worst open node.
 	goc::Valuation ub; // Best int solution found so far.
-	int node_seq; // number of nodes created.
+	std::vector<goc::Route> ub_routes; // routes of ub (its variables may be removed from the formulation later).
+	std::atomic<int> node_seq; // number of nodes created.
+	std::multiset<double> active_bounds; // bounds of the nodes that are being branched by the workers.
+	std::mutex tree_mutex; // guards q, z_ub, z_lb, ub, active_bounds, rolex and log.
+	std::condition_variable tree_cv; // notified when q, active_bounds or the status change.
+	std::mutex pool_mutex; // guards the global pool of routes (spf) while the workers run concurrently.
 	goc::Stopwatch rolex; // Stopwatch to measure the time spent in the algorithm.
 	
-	goc::Digraph D;
-	SPF* spf;
-	goc::LPSolver lp_solver;
-	goc::CGSolver cg_solver;
+	std::shared_ptr<const VRPInstance> vrp; // instance shared with the pricing solver.
+	SPF* spf; // global pool of routes and cuts.
+	std::vector<std::unique_ptr<SPF>> spf_pool; // clones of spf to evaluate strong branching candidates concurrently.
+	std::unique_ptr<Worker> master; // worker that solves the relaxations on spf.
+	std::vector<std::unique_ptr<Worker>> workers; // tree workers (only if tree_threads > 1).
 	goc::BCPExecutionLog log;
 };
 } // namespace networks2019
@@ -24,6 +24,9 @@ public:
 	std::vector<SubsetRowCut> S; // Cuts in the formulation.
 	std::vector<double> sigma; // Duals associated with the cuts C.
 	
+	// Returns: the reduced cost of route r (its duration minus the profits and the duals of the cuts it violates).
+	double ReducedCost(const goc::Route& r) const;
+	
 	virtual void Print(std::ostream& os) const;
 };
 
@@ -18,11 +18,21 @@ namespace networks2019
 typedef VertexSet SubsetRowCut; // We only consider cuts with n = 3, k = 2. So the set of vertices define the cut.
 class PricingProblem;
 
+// Basis of the SPF relaxation where the variables are identified by their route ids instead of their column index, so
+// that it can be restored after the columns in the LP changed (e.g. some of them were moved to the pool).
+struct SPFBasis
+{
+	std::vector<std::pair<int, goc::Basis::Status>> routes; // (id, status) of the routes that are not at lower bound.
+	std::vector<goc::Basis::Status> constraint_status; // status of the slack of each constraint.
+};
+
 // Represents a set-partitioning formulation for the VRP.
 // min c_j y_j															(0)
 // s.t.
 //		sum_{j \in \Omega} a_ij y_j = 1 	\forall i \in V - {o, d}	(1)
 //		y_j >= 0							\forall j \in \Omega		(2)
+// Each route has a stable id (its position in Omega). Routes whose columns are not useful for a while can be moved to
+// an off-LP pool (their columns are removed from the formulation) and restored later, keeping their ids.
 class SPF
 {
 public:
@@ -37,30 +47,90 @@ public:
 	~SPF();
 	
 	// Adds the specified route to the formulation (using the duration as its cost).
+	// If the route contains a forbidden arc, y_j = 0.
 	void AddRoute(const goc::Route& r);
 	
+	// Adds the specified routes to the formulation (using the duration as their cost) with a single update of the
+	// formulation. If a route contains a forbidden arc, y_j = 0.
+	void AddRoutes(const std::vector<goc::Route>& routes);
+	
+	// Updates the age of the columns in the LP with their reduced costs for the duals. The age of a column is the
+	// number of consecutive updates in which its reduced cost was positive (i.e. it was not in the basis).
+	void UpdateColumnAges(const std::vector<double>& duals);
+	
+	// Moves the columns in the LP with age >= max_age to the pool (they are removed from the formulation).
+	// Returns: the number of columns moved.
+	int PurgeColumns(int max_age);
+	
+	// Moves back to the LP the routes in the pool with negative reduced cost for the duals and no forbidden arcs.
+	// Returns: the number of columns restored.
+	int RestoreColumns(const std::vector<double>& duals);
+	
+	// Moves back to the LP all the routes in the pool.
+	// Returns: the number of columns restored.
+	int RestoreAllColumns();
+	
+	// Returns: a new SPF with the same routes and cuts on a new formulation, which can be solved concurrently with this
+	// one. The forbidden arcs are not copied.
+	// Observation: memory should be managed by the receiver and the pointer should be freed.
+	SPF* Clone() const;
+	
+	// Adds to this SPF the routes and cuts of spf that are not present yet.
+	// Precondition: the routes and cuts of this SPF are a prefix of the ones in spf (e.g., it is a clone of spf).
+	void Sync(const SPF& spf);
+	
 	// Adds a subset row cut with n = 3, k = 2.
 	// \sum_{j \in Omega and #(r_j \cap cut) >= 2} y_j <= 1.0.
 	void AddCut(const SubsetRowCut& cut);
 	
+	// Adds the subset row cuts with a single update of the formulation.
+	void AddCuts(const std::vector<SubsetRowCut>& new_cuts);
+	
 	//	- Sets y_j = 0 for all j that contains any arc in A.
+	// Only the columns whose status changes with respect to the previous forbidden arcs are updated.
 	void SetForbiddenArcs(const std::vector<goc::Arc>& A);
 	
 	// Returns: the route associated to the variable.
 	const goc::Route& RouteOf(const goc::Variable& variable) const;
 	
+	// Returns: the number of routes (in the LP or in the pool).
+	int RouteCount() const;
+	
+	// Sets the basis to warm start the next relaxation solved.
+	// If a route that is not at lower bound in the basis is not in the LP, no basis is set.
+	void SetBasis(const SPFBasis& basis);
+	
 	// Returns: the pricing problem for the duals.
 	PricingProblem InterpretDuals(const std::vector<double>& duals) const;
 	
 	// Interprets an integer solution of the formulation and returns the routes selected.
 	std::vector<goc::Route> InterpretSolution(const goc::Valuation& z) const;
 	
+	// Returns: the pairs (route, value) for the routes with non-zero value in z.
+	std::vector<std::pair<goc::Route, double>> InterpretRelaxation(const goc::Valuation& z) const;
+	
+	// Returns: the basis of the formulation with the columns identified by their route ids.
+	SPFBasis InterpretBasis(const goc::Basis& basis) const;
+	
 private:
 	std::vector<goc::Arc> forbidden_arcs; // arcs that are removed from the SPF (i.e. all routes containing one of these arcs are set to 0).
+	goc::Matrix<bool> is_forbidden; // is_forbidden[i][j] = (i, j) \in forbidden_arcs.
 	int n; // number of vertices.
-	std::vector<goc::Route> omega; // set of routes in the restricted master problem.
-	std::vector<goc::Variable> y; // variables associated with routes in omega.
+	std::vector<goc::Route> omega; // set of routes (in the LP or in the pool), the id of a route is its index.
+	std::vector<VertexSet> visited; // visited[j] = vertices in the path of route j.
+	std::vector<goc::Variable> y; // variables associated with routes in omega (only valid if in_lp[j]).
+	std::vector<bool> in_lp; // in_lp[j] = route j has a column in the LP (otherwise it is in the pool).
+	std::vector<int> age; // age[j] = number of consecutive age updates with positive reduced cost of route j.
+	std::vector<int> forbidden_count; // forbidden_count[j] = number of forbidden arcs in the path of route j.
+	std::vector<bool> fixed; // fixed[j] = the column of route j has its upper bound set to 0.
+	std::vector<int> column_route; // column_route[k] = id of the route of the k-th column in the LP.
 	goc::Matrix<std::vector<int>> omega_by_arc; // omega_by_arc[i][j] = { r \in omega : (i, j) \in path(r) }.
+	
+	// Adds the columns of the routes with the specified ids to the LP.
+	void AddColumns(const std::vector<int>& ids);
+	
+	// Returns: the reduced cost of route j for the duals.
+	double ReducedCost(int j, const std::vector<double>& duals) const;
 };
 } // namespace networks2019
 
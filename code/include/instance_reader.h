@@ -0,0 +1,40 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef NETWORKS2019_INSTANCE_READER_H
+#define NETWORKS2019_INSTANCE_READER_H
+
+#include <istream>
+#include <goc/goc.h>
+
+#include "vrp_instance_builder.h"
+#include "tdcarp/tdcarp_instance.h"
+
+namespace networks2019
+{
+// The readers parse the next JSON instance from the stream without building its document: the large attributes (the
+// digraph, travel times, time windows, etc.) are stored directly in their typed structures while they are read, and the
+// remaining attributes (e.g. instance_name, capacity, profits) are kept in the small JSON of the attributes.
+// The result is the same as parsing the document and converting it with from_json.
+
+// Reads a vehicle routing problem instance with the following attributes stored directly:
+//	- digraph
+//	- travel_times (optional)
+//	- time_windows (optional)
+//	- service_times (optional)
+//	- demands (optional)
+//	- distances, clusters, cluster_speeds, speed_zones (optional).
+// Returns: the builder of the instance, and the remaining attributes in *attributes.
+// Exception: if the stream does not start with a valid JSON object.
+VRPInstanceBuilder read_vrp_instance(std::istream& is, nlohmann::json* attributes);
+
+// Reads a TDCARP instance with the graph (vertex_count and edges) stored directly.
+// Returns: the instance, and the remaining attributes in *attributes.
+// Exception: if the stream does not start with a valid JSON object.
+TDCARPInstance read_tdcarp_instance(std::istream& is, nlohmann::json* attributes);
+} // namespace networks2019
+
+#endif //NETWORKS2019_INSTANCE_READER_H
@@ -7,6 +7,7 @@
 #ifndef NETWORKS2019_BIDIRECTIONAL_LABELING_H
 #define NETWORKS2019_BIDIRECTIONAL_LABELING_H
 
+#include <memory>
 #include <vector>
 #include <tuple>
 
@@ -38,7 +39,12 @@ public:
 	bool correcting; // Indicates if the correcting step is executed.
 	bool symmetric; // Indicates if symmetric bidirectional labeling should be applied (or asymmetric if false).
 	
-	BidirectionalLabeling(const VRPInstance& vrp);
+	// Creates a bidirectional labeling over the shared instance vrp, the reverse instance is built from it.
+	BidirectionalLabeling(std::shared_ptr<const VRPInstance> vrp);
+	
+	// Creates a bidirectional labeling over the shared instance vrp and its shared reverse instance.
+	// Precondition: reverse_vrp is the result of reverse_instance(*vrp).
+	BidirectionalLabeling(std::shared_ptr<const VRPInstance> vrp, std::shared_ptr<const VRPInstance> reverse_vrp);
 	
 	// Runs the bidirectional labeling algorithm and leaves the negative reduced cost routes on the parameter R.
 	// Returns: the execution information log.
@@ -57,7 +63,7 @@ private:
 	// Adds a solution to the pool S if it is the best yet found with those visited vertices.
 	void AddSolution(const goc::GraphPath& p, double min_duration);
 	
-	VRPInstance vrp_;
+	std::shared_ptr<const VRPInstance> vrp_; // instance shared with the forward labeling.
 	PricingProblem pp_;
 	MonodirectionalLabeling lbl_[2]; // lbl_[0] = forward, lbl_[1] = backward.
 	MonodirectionalLabeling::DominanceStructure M[2]; // Processed labels are stored in M[v][q] sorted by min_cost(l).
@@ -66,6 +72,14 @@ private:
 	// We only keep the best solution for each set of visited vertices.
 	std::unordered_map<VertexSet, goc::Route> S;
 };
+
+// Reverses a VRP instance.
+// o' := d
+// d' := o
+// D' := reverse(D)
+// tw'(v) := [T-b(v), T-a(v)]
+// arr'_vu(t) := T-dep_uv(T-t)
+VRPInstance reverse_instance(const VRPInstance& vrp);
 } // namespace networks2019
 
 #endif //NETWORKS2019_BIDIRECTIONAL_LABELING_H
@@ -7,6 +7,7 @@
 #ifndef NETWORKS2019_MONODIRECTIONAL_LABELING_H
 #define NETWORKS2019_MONODIRECTIONAL_LABELING_H
 
+#include <memory>
 #include <vector>
 #include <tuple>
 
@@ -50,7 +51,8 @@ public:
 	DominanceStructure U; // Indexed by last vertex, demand and sorted by c_min.
 	int processed_count; // Number of labels in the dominance structure.
 	
-	MonodirectionalLabeling(const VRPInstance& vrp);
+	// Creates a labeling over the shared instance vrp (it is never modified, so many labelings may use it).
+	MonodirectionalLabeling(std::shared_ptr<const VRPInstance> vrp);
 	
 	~MonodirectionalLabeling();
 	
@@ -89,8 +91,9 @@ private:
 	// Resets the dominance structures and counters.
 	void Clean();
 	
-	VRPInstance vrp_;
+	std::shared_ptr<const VRPInstance> vrp_; // instance shared with the other labelings.
 	PricingProblem pp_;
+	goc::FilteredDigraph graph_; // CSR view of vrp_->D with the pricing problem forbidden arcs masked.
 	Label no_label; // null object pattern of the label to avoid using ifs.
 };
 } // namespace networks2019
@@ -0,0 +1,37 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef NETWORKS2019_PREPROCESS_BREAKPOINTS_H
+#define NETWORKS2019_PREPROCESS_BREAKPOINTS_H
+
+#include <goc/goc.h>
+
+#include "vrp_instance_builder.h"
+
+namespace networks2019
+{
+// Number of pieces of the travel time functions before and after the breakpoint reduction.
+class BreakpointReduction
+{
+public:
+	int piece_count_before = 0; // total number of pieces of the travel times before the reduction.
+	int piece_count_after = 0; // total number of pieces of the travel times after the reduction.
+};
+
+// Takes an instance of the vehicle routing problems that uses the following attributes:
+//	- digraph
+//	- travel_times
+// Reduces the number of breakpoints of the travel times by merging the nearly collinear pieces of the arrival time
+// functions t+\tau_ij(t), within the given absolute tolerance. The new travel times satisfy
+// \tau_ij(t) <= \tau'_ij(t) <= \tau_ij(t) + tolerance, and keep the FIFO property. Therefore, the routes feasible with
+// \tau' are feasible with \tau (the reduction is conservative), but their durations may be overestimated.
+// Returns: the number of pieces before and after the reduction.
+BreakpointReduction preprocess_breakpoints(VRPInstanceBuilder& instance, double tolerance);
+
+void to_json(nlohmann::json& j, const BreakpointReduction& reduction);
+} // namespace networks2019
+
+#endif //NETWORKS2019_PREPROCESS_BREAKPOINTS_H
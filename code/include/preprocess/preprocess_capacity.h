@@ -9,14 +9,16 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+
 namespace networks2019
 {
-// Takes a JSON instance of the vehicle routing problems with the following attributes:
+// Takes an instance of the vehicle routing problems that uses the following attributes:
 //	- digraph
 //	- capacity
 //	- demands
 // Removes arcs (i, j) such that q_i+q_j > Q.
-void preprocess_capacity(nlohmann::json& instance);
+void preprocess_capacity(VRPInstanceBuilder& instance);
 } // namespace networks2019
 
 #endif //NETWORKS2019_PREPROCESS_CAPACITY_H
@@ -9,9 +9,11 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+
 namespace networks2019
 {
-// Takes a JSON instance of the vehicle routing problems with the following attributes:
+// Takes an instance of the vehicle routing problems that uses the following attributes:
 //	- digraph
 //	- travel_times
 //	- time_windows (optional)
@@ -21,7 +23,7 @@ namespace networks2019
 // 	(i) 	s'i = 0.
 // 	(ii) 	a'_i = a_i + s_i, b'_i = b_i + s_i for each i \in V.
 // 	(iii) 	\tau'_ij(t) = max(a_j, t+\tau_ij(t)) - t + s_j for each ij \in A.
-void preprocess_service_waiting(nlohmann::json& instance);
+void preprocess_service_waiting(VRPInstanceBuilder& instance);
 } // namespace networks2019
 
 #endif //NETWORKS2019_PREPROCESS_SERVICE_WAITING_H
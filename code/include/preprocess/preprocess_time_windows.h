@@ -9,9 +9,11 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+
 namespace networks2019
 {
-// Takes a JSON instance of the vehicle routing problems with the following attributes:
+// Takes an instance of the vehicle routing problems that uses the following attributes:
 //	- digraph
 //	- travel_times
 //	- time_windows
@@ -20,9 +22,10 @@ namespace networks2019
 // Assumes preprocess_service_waiting was called (i.e. instance has no service nor waiting times).
 // Shrinks time windows [a_i, b_i] according to the techinques introduced in:
 //	Desrosiers, J., Dumas, Y., Solomon, M. M., & Soumis, F. (1995).
-// and removes infeasible arcs.
+// and removes infeasible arcs and the arcs removed by preprocess_triangle_depot.
+// The rules are applied until a fixed point is reached (i.e. until no time window shrinks and no arc is removed).
 // Only applies preprocessing techniques that do not require that all vertices all visited in one route.
-void preprocess_time_windows(nlohmann::json& instance);
+void preprocess_time_windows(VRPInstanceBuilder& instance);
 } // namespace networks2019
 
 #endif //NETWORKS2019_PREPROCESS_TIME_WINDOWS_H
@@ -9,11 +9,13 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+
 using namespace goc;
 
 namespace networks2019
 {
-// Takes a JSON instance of the vehicle routing problems with the following attributes:
+// Takes an instance of the vehicle routing problems that uses the following attributes:
 //	- digraph
 //	- distances
 //	- clusters
@@ -21,10 +23,22 @@ namespace networks2019
 //	- speed_zones
 //	- service_times (optional)
 //	- time_windows (optional).
-// Adds the travel_times attribute to a JSON instance with a matrix of piecewise linear functions.
-void preprocess_travel_times(nlohmann::json& instance);
+// Sets the travel times of the instance to the ones of the quickest paths between every pair of vertices.
+void preprocess_travel_times(VRPInstanceBuilder& instance);
+
+// Returns: a matrix with the travel time functions of the quickest paths between every pair of vertices, where
+// quickest[v][w](t) = earliest arrival at w departing from v at t, minus t (empty if w is unreachable from v).
+//	- arriving_times[i][j](t): arrival time at j when departing from i at t, for each arc (i, j) of D.
+//	- horizon: interval of the departure times from each vertex.
+Matrix<goc::PWLFunction> quickest_paths(const Digraph& D, const Matrix<goc::PWLFunction>& arriving_times, Interval horizon);
 
-Matrix<goc::PWLFunction> quickest_paths(Digraph D, Matrix<goc::PWLFunction> arriving_times, Interval horizon);
+// Returns: a matrix with the travel time functions of the quickest paths from each source to every vertex, where
+// quickest[k][w](t) = earliest arrival at w departing from sources[k] at t, minus t (empty if w is unreachable).
+//	- arriving_times: arrival time at j when departing from i at t, for each arc (i, j) of D.
+//	- horizon: interval of the departure times from each source.
+// Observation: it runs a profile search from each source concurrently.
+Matrix<goc::PWLFunction> quickest_paths(const Digraph& D, const goc::ArcTable<goc::PWLFunction>& arriving_times,
+	Interval horizon, const std::vector<goc::Vertex>& sources);
 } // namespace networks2019
 
 #endif //NETWORKS2019_PREPROCESS_TRAVEL_TIMES_H
@@ -9,16 +9,22 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+
 namespace networks2019
 {
-// Takes a JSON instance of the vehicle routing problems with the following attributes:
+// Takes an instance of the vehicle routing problems that uses the following attributes:
 //	- digraph
 //	- travel_times
 //	- time_windows
 //	- start_depot
 // 	- end_depot
 // Removes arcs that are worse than going to the depot and leaving again.
-void preprocess_triangle_depot(nlohmann::json& instance);
+void preprocess_triangle_depot(VRPInstanceBuilder& instance);
+
+// Returns: if the arc e is worse than going from its tail to the depot and leaving again to its head (i.e. it is
+// removed by preprocess_triangle_depot).
+bool is_dominated_by_depot(const VRPInstanceBuilder& instance, goc::Arc e);
 } // namespace networks2019
 
 #endif //NETWORKS2019_PREPROCESS_TRIANGLE_DEPOT_H
@@ -0,0 +1,51 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef NETWORKS2019_TDCARP_INSTANCE_H
+#define NETWORKS2019_TDCARP_INSTANCE_H
+
+#include <vector>
+#include <goc/goc.h>
+
+#include "vrp_instance.h"
+
+namespace networks2019
+{
+// Edge of the road network of a TDCARP instance, traversed from tail to head.
+// Its speed is constant inside each piece of the horizon, piece k ends at piece_ends[k] and has speed speeds[k].
+class TDCARPEdge
+{
+public:
+	goc::Vertex tail, head; // endpoints of the edge.
+	double distance; // length of the edge.
+	CapacityUnit demand; // demand of the edge (the edge is required if it is positive).
+	std::vector<TimeUnit> piece_ends; // piece_ends[k] = end of piece k of the horizon.
+	std::vector<double> speeds; // speeds[k] = speed of the edge during piece k.
+};
+
+// This class represents the attributes of a JSON instance of the time dependent capacitated arc routing problem.
+class TDCARPInstance
+{
+public:
+	int vertex_count; // number of vertices of the road network.
+	std::vector<TDCARPEdge> edges; // edges of the road network.
+	goc::Vertex depot; // vertex where the routes start and end.
+	goc::Interval horizon; // planning horizon.
+	double service_speed_factor; // factor of the travel time of an edge to serve it.
+	CapacityUnit capacity; // vehicle capacity.
+	
+	// Sets the depot, horizon, service speed factor and capacity from the JSON attributes of the instance.
+	void SetAttributes(const nlohmann::json& attributes);
+};
+
+// Parses an edge of a TDCARP instance.
+void from_json(const nlohmann::json& j, TDCARPEdge& edge);
+
+// Parses the attributes of a TDCARP instance.
+void from_json(const nlohmann::json& j, TDCARPInstance& instance);
+} // namespace networks2019
+
+#endif //NETWORKS2019_TDCARP_INSTANCE_H
@@ -9,10 +9,29 @@
 
 #include <goc/goc.h>
 
+#include "vrp_instance_builder.h"
+#include "tdcarp/tdcarp_instance.h"
+
 namespace networks2019
 {
+// Times of the stages of the transformation of a TDCARP instance.
+class TransformationLog
+{
+public:
+	goc::Duration time; // total time of the transformation.
+	goc::Duration travel_times_time; // time computing the travel time function of each edge of the road network.
+	goc::Duration quickest_paths_time; // time computing the quickest paths between the serviced edges.
+	goc::Duration digraph_time; // time building the travel times and digraph of the TDVRPTW instance.
+};
+
+// Returns: the TDVRPTW instance where each vertex other than the depots is a required edge of the TDCARP instance, and
+// the travel time of an arc includes the service of the edge at its head. The arcs without a feasible path are omitted.
+// Observation: the quickest paths are computed on the (sparse) road network, only from the depot and the heads of the
+// serviced edges, concurrently.
+// If log != nullptr, the times of the stages are stored in *log.
+VRPInstanceBuilder transform_problem(const TDCARPInstance& instance, TransformationLog* log = nullptr);
 
-nlohmann::json transform_problem(nlohmann::json& instance);
+void to_json(nlohmann::json& j, const TransformationLog& log);
 } // namespace networks2019
 
 #endif //NETWORKS2019_TRANSFORM_PROBLEM_H
@@ -25,6 +25,8 @@ typedef std::bitset<MAX_N> VertexSet; // Set of vertices.
 // This class represents an instance of a vehicle routing problem.
 // Considerations:
 // 	- It considers two depots (origin and destination).
+// 	- The travel functions are stored for the arcs of D in its CSR order (like FilteredDigraph(D)), and for the loops
+// 	  (i, i) as boundary functions.
 class VRPInstance : public goc::Printable
 {
 public:
@@ -34,10 +36,10 @@ public:
 	std::vector<goc::Interval> tw; // time window of customers (tw[i] = time window of customer i).
 	CapacityUnit Q; // vehicle capacity.
 	std::vector<CapacityUnit> q; // demand of customers (q[i] = demand of customer i).
-	goc::Matrix<goc::PWLFunction> tau; // tau[i][j](t) = travel time of arc (i, j) if departing from i at t.
-	goc::Matrix<goc::PWLFunction> pretau; // pretau[i][j](t) = travel time of arc (i, j) if arriving at j at t.
-	goc::Matrix<goc::PWLFunction> dep; // dep[i][j](t) = departing time of arc (i, j) if arriving to j at t.
-	goc::Matrix<goc::PWLFunction> arr; // arr[i][j](t) = arrival time of arc (i, j) if departing from i at t.
+	goc::ArcTable<goc::PWLFunction> tau; // tau[i][j](t) = travel time of arc (i, j) if departing from i at t.
+	goc::ArcTable<goc::PWLFunction> pretau; // pretau[i][j](t) = travel time of arc (i, j) if arriving at j at t.
+	goc::ArcTable<goc::PWLFunction> dep; // dep[i][j](t) = departing time of arc (i, j) if arriving to j at t.
+	goc::ArcTable<goc::PWLFunction> arr; // arr[i][j](t) = arrival time of arc (i, j) if departing from i at t.
 	goc::Matrix<TimeUnit> LDT; // LDT[i][j] = latest time i can depart from i to reach j before its deadline.
 	
 	// Returns: the travel time for arc e if departing at t0.
@@ -65,13 +67,24 @@ public:
 	goc::Route BestDurationRoute(const goc::GraphPath& p) const;
 	
 	// Returns: a set of all vertices which are unreachable if departing from v at t0.
+	// Precondition: BuildUnreachableIndex() was called after the last change to LDT.
 	VertexSet Unreachable(goc::Vertex v, TimeUnit t0) const;
 	
 	// Returns: a set of some vertices which are unreachable if departing from v at t0.
+	// Precondition: BuildUnreachableIndex() was called after the last change to tw.
 	VertexSet WeakUnreachable(goc::Vertex v, TimeUnit t0) const;
 	
+	// Builds the lookup structures used by Unreachable and WeakUnreachable from LDT and tw.
+	void BuildUnreachableIndex();
+	
 	// Prints the JSON representation of the instance.
 	virtual void Print(std::ostream& os) const;
+
+private:
+	std::vector<std::vector<TimeUnit>> ldt_sorted_; // ldt_sorted_[v] = {LDT[v][w] : w \in V(D)} sorted ascendingly.
+	std::vector<std::vector<VertexSet>> ldt_prefix_; // ldt_prefix_[v][k] = vertices w with the k smallest LDT[v][w].
+	std::vector<TimeUnit> deadline_sorted_; // {tw[w].right : w \in V(D)} sorted ascendingly.
+	std::vector<VertexSet> deadline_prefix_; // deadline_prefix_[k] = vertices w with the k smallest tw[w].right.
 };
 
 // Serializes the instance.
@@ -0,0 +1,56 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef NETWORKS2019_VRP_INSTANCE_BUILDER_H
+#define NETWORKS2019_VRP_INSTANCE_BUILDER_H
+
+#include <vector>
+#include <goc/goc.h>
+
+#include "vrp_instance.h"
+
+namespace networks2019
+{
+// This class represents the attributes of a JSON instance of a vehicle routing problem, parsed once so that the
+// preprocessing passes can work on them before building the VRPInstance.
+// Attributes that are missing in the JSON take default values (e.g. depots 0 and n-1, no service times, the horizon as
+// time windows).
+class VRPInstanceBuilder
+{
+public:
+	goc::Digraph D; // digraph representing the network.
+	goc::Vertex o, d; // origin and destination depot.
+	goc::Interval horizon; // planning horizon.
+	std::vector<goc::Interval> tw; // time window of customers (tw[i] = time window of customer i).
+	std::vector<TimeUnit> s; // service times (s[i] = service time of customer i).
+	CapacityUnit Q; // vehicle capacity.
+	std::vector<CapacityUnit> q; // demand of customers (q[i] = demand of customer i).
+	goc::Matrix<goc::PWLFunction> tau; // tau[i][j](t) = travel time of arc (i, j) if departing from i at t.
+	goc::Matrix<double> distances; // distances[i][j] = distance of arc (i, j) (only to compute tau).
+	goc::Matrix<int> clusters; // clusters[i][j] = cluster of arc (i, j) (only to compute tau).
+	std::vector<std::vector<double>> cluster_speeds; // cluster_speeds[c][k] = speed of cluster c in speed zone k.
+	std::vector<goc::Interval> speed_zones; // speed_zones[k] = interval of speed zone k.
+	
+	// Sets the depots, horizon and capacity from the JSON attributes of the instance, and the default values of the
+	// vectors and functions that were not given (i.e. are empty).
+	// Precondition: D is set.
+	void SetAttributes(const nlohmann::json& attributes);
+	
+	// Removes the arc e from the digraph, and its travel time function.
+	void RemoveArc(goc::Arc e);
+	
+	// Removes the arcs from the digraph, and their travel time functions.
+	void RemoveArcs(const std::vector<goc::Arc>& arcs);
+	
+	// Returns: the instance with the attributes of the builder, including its travel functions and lookup structures.
+	VRPInstance Build() const;
+};
+
+// Parses the attributes of an instance.
+void from_json(const nlohmann::json& j, VRPInstanceBuilder& builder);
+} // namespace networks2019
+
+#endif //NETWORKS2019_VRP_INSTANCE_BUILDER_H
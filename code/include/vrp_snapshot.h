@@ -0,0 +1,45 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#ifndef NETWORKS2019_VRP_SNAPSHOT_H
+#define NETWORKS2019_VRP_SNAPSHOT_H
+
+#include <string>
+#include <goc/goc.h>
+
+#include "vrp_instance.h"
+#include "preprocess/preprocess_breakpoints.h"
+
+namespace networks2019
+{
+// A snapshot is a binary file with a preprocessed instance and its reverse (as used by the bidirectional labeling), so
+// that experiments on the same instance do not repeat the preprocessing.
+// Format (native endianness):
+//	- header: magic "VRPSNAP", version, breakpoint tolerance of the preprocessing, payload size and FNV-1a checksum of
+//	  the payload.
+//	- payload: instance name, piece counts of the breakpoint reduction, and for the instance and its reverse: n, o, d, T, Q, the arcs (in the digraph order), tw,
+//	  q, the functions tau, arr, dep, pretau (for the loops and then for the arcs in CSR order, the piece count followed
+//	  by the flat array of pieces) and LDT.
+// Observation: the snapshot is loaded by mapping the file into memory.
+
+// Returns: if there is a snapshot file in the path.
+bool snapshot_exists(const std::string& path);
+
+// Writes the snapshot of the instance with the given name and its reverse to the path.
+// breakpoint_tolerance: tolerance of the breakpoint reduction used to preprocess the instance (0 if none was used).
+// breakpoint_reduction: piece counts of the breakpoint reduction (ignored if none was used).
+void save_snapshot(const std::string& path, const std::string& instance_name, double breakpoint_tolerance,
+	const BreakpointReduction& breakpoint_reduction, const VRPInstance& vrp, const VRPInstance& reverse_vrp);
+
+// Loads the instance, its reverse and the piece counts of its breakpoint reduction from the snapshot in the path.
+// breakpoint_tolerance: tolerance of the breakpoint reduction expected in the preprocessing of the snapshot.
+// Exception: if the file is not a snapshot of the current version, it is corrupted, it belongs to another instance, or
+// it was preprocessed with another breakpoint tolerance.
+void load_snapshot(const std::string& path, const std::string& instance_name, double breakpoint_tolerance,
+	BreakpointReduction* breakpoint_reduction, VRPInstance* vrp, VRPInstance* reverse_vrp);
+} // namespace networks2019
+
+#endif //NETWORKS2019_VRP_SNAPSHOT_H
@@ -6,49 +6,123 @@
 
 #include "bcp/bcp.h"
 
+#include <algorithm>
 #include <climits>
+#include <tuple>
 
 using namespace std;
 using namespace goc;
+using namespace nlohmann;
 
 namespace networks2019
 {
-BCP::BCP(const Digraph& D, SPF* spf) : D(D), spf(spf), z_lb(-INFTY), z_ub(INFTY), node_seq(0)
+namespace
+{
+// Returns: the number of threads that the CPLEX configuration asks for, or 1 if it lets CPLEX decide (in that case, the
+// threads are not reserved from the budget).
+int requested_threads(const json& config)
+{
+	int threads = value_or_default(config, "CPX_PARAM_THREADS", 0);
+	return max(1, threads);
+}
+
+// Returns: the CPLEX configuration with the threads granted by the reservation, unless it lets CPLEX decide.
+json reserved_config(const json& config, const ThreadReservation& reservation)
+{
+	json reserved = config;
+	int threads = value_or_default(config, "CPX_PARAM_THREADS", 0);
+	if (threads > 0) reserved["CPX_PARAM_THREADS"] = reservation.Count();
+	return reserved;
+}
+}
+
+BCP::BCP(shared_ptr<const VRPInstance> vrp, SPF* spf) : vrp(vrp), spf(spf), z_lb(-INFTY), z_ub(INFTY), node_seq(0)
 {
 	time_limit = Duration::Max();
 	node_limit = cut_limit = INT_MAX;
-	pricing_solver = [] (const PricingProblem&, int, Duration, CGExecutionLog*) { fail("Pricing solver not implemented."); };
-	cg_solver.screen_output = &clog;
-	cg_solver.lp_solver = &lp_solver;
-	cg_solver.pricing_function = [&] (const vector<double>& duals, double incumbent_value, Duration time_limit, CGExecutionLog* cg_execution_log) {
-		int variable_count = this->spf->formulation->VariableCount();
+	strong_branch_size = 10;
+	strong_branch_threads = 1;
+	cuts_per_round = 1;
+	separation_threads = 1;
+	tree_threads = 1;
+	column_age_limit = INT_MAX;
+	dual_stabilization = CGStabilization::None;
+	smoothing_factor = 0.8;
+	cg_gap_tolerance = 0.0;
+	lp_config = root_lp_config = mip_config = json::object();
+	pricing_solver = [] (const PricingProblem&, int, int, Duration, CGExecutionLog*, vector<Route>*) { fail("Pricing solver not implemented."); return -INFTY; };
+	master = CreateWorker(0, spf, false);
+}
+
+unique_ptr<BCP::Worker> BCP::CreateWorker(int index, SPF* relaxation, bool owned)
+{
+	unique_ptr<Worker> worker(new Worker());
+	worker->index = index;
+	worker->spf = relaxation;
+	if (owned) worker->clone.reset(relaxation);
+	worker->separate_cuts = false;
+	worker->cg_solver.screen_output = &clog;
+	worker->cg_solver.lp_solver = &worker->lp_solver;
+	worker->cg_solver.column_sum_bound = vrp->D.VertexCount() - 2; // each route visits at least one customer.
+	Worker* w = worker.get();
+	worker->cg_solver.pricing_function = [this, w] (const vector<double>& duals, double incumbent_value, Duration time_limit, CGExecutionLog* cg_execution_log) {
+		int variable_count = w->spf->formulation->VariableCount();
 		Stopwatch iteration_rolex(true);
-		auto pp = this->spf->InterpretDuals(duals);
-		pricing_solver(pp, 0, time_limit, cg_execution_log);
-		*log.pricing_time += iteration_rolex.Peek();
+		auto pp = w->spf->InterpretDuals(duals);
+		
+		// Age the columns, and try the routes in the pool before solving the pricing problem. The ages and the pool
+		// only follow the duals of the master, the stabilized duals are not a solution of the LP.
+		if (column_age_limit < INT_MAX && !cg_execution_log->stabilized_duals)
+		{
+			w->spf->UpdateColumnAges(duals);
+			if (w->spf->RestoreColumns(duals) > 0)
+			{
+				lock_guard<mutex> lock(tree_mutex);
+				*log.pricing_time += iteration_rolex.Peek();
+				return -INFTY;
+			}
+		}
 		
-		// If no variable were added and we are in root node, separate cuts.
-		if (node_seq == 1 && variable_count == this->spf->formulation->VariableCount())
+		vector<Route> routes;
+		double min_reduced_cost = pricing_solver(pp, 0, w->index, time_limit, cg_execution_log, &routes);
+		AddRoutes(w, routes);
+		{
+			lock_guard<mutex> lock(tree_mutex);
+			*log.pricing_time += iteration_rolex.Peek();
+		}
+		
+		// If no variable were added for the duals of the master and we are in root node, separate cuts.
+		if (w->separate_cuts && !cg_execution_log->stabilized_duals && variable_count == w->spf->formulation->VariableCount())
 		{
 			int cuts_added = 0;
-			while (this->spf->cuts.size() < cut_limit)
+			while (w->spf->cuts.size() < cut_limit)
 			{
 				Stopwatch cut_rolex(true);
-				lp_solver.time_limit = time_limit - iteration_rolex.Peek();
-				auto lp_log = lp_solver.Solve(this->spf->formulation, {LPOption::Incumbent});
+				w->lp_solver.time_limit = time_limit - iteration_rolex.Peek();
+				auto lp_log = w->lp_solver.Solve(w->spf->formulation, {LPOption::Incumbent});
 				if (lp_log.status != LPStatus::Optimum) break;
-				bool added_cuts = SeparateCuts(lp_log.incumbent);
+				int round_cuts = SeparateCuts(lp_log.incumbent, min(cuts_per_round, cut_limit - (int)w->spf->cuts.size()));
 				log.cut_family_iteration_count->at("SR")++;
 				log.cut_family_cut_time->at("SR") += cut_rolex.Peek();
 				*log.cut_time += cut_rolex.Peek();
-				if (!added_cuts) break;
-				log.cut_family_cut_count->at("SR")++;
-				log.cut_count++;
-				cuts_added++;
+				if (round_cuts == 0) break;
+				log.cut_family_cut_count->at("SR") += round_cuts;
+				*log.cut_count += round_cuts;
+				cuts_added += round_cuts;
 			}
 			if (cuts_added > 0) clog << "\tCuts: " << cuts_added << endl;
 		}
+		return min_reduced_cost;
 	};
+	return worker;
+}
+
+void BCP::AddRoutes(Worker* worker, const vector<Route>& routes)
+{
+	if (routes.empty()) return;
+	lock_guard<mutex> lock(pool_mutex);
+	spf->AddRoutes(routes);
+	if (worker->spf != spf) worker->spf->Sync(*spf);
 }
 
 BCPExecutionLog BCP::Run(VRPSolution* solution)
@@ -71,8 +145,8 @@ BCPExecutionLog BCP::Run(VRPSolution* solution)
 	
 	// Create root node and solve.
 	clog << "Processing root node." << endl;
-	Node* root = new Node{0, INFTY, {}};
-	ProcessNode(root);
+	Node* root = new Node{0, INFTY, {}, {}, {}};
+	ProcessNode(root, master.get());
 	log.root_time = rolex.Peek();
 
 	if (!q.empty())
@@ -86,26 +160,17 @@ BCPExecutionLog BCP::Run(VRPSolution* solution)
 		tstream.AddColumn("time", 10).AddColumn("#closed", 10).AddColumn("#open", 10).AddColumn("LB", 10).AddColumn("UB", 10).AddColumn("#cols", 10);
 		tstream.WriteHeader();
 		
-		while (!q.empty())
+		ThreadReservation tree_reservation(tree_threads);
+		int worker_count = tree_reservation.Count();
+		if (worker_count <= 1)
 		{
-			if (log.status == BCStatus::TimeLimitReached || log.status == BCStatus::MemoryLimitReached) break;
-			if (log.nodes_closed >= node_limit) { log.status = BCStatus::NodeLimitReached; break; }
-			
-			// Pop node.
-			Node* n = q.top();
-			q.pop();
-			log.nodes_open--;
-			log.nodes_closed++;
-			
-			if (epsilon_bigger(z_ub, n->bound))
-			{
-				z_lb = n->bound; // Update z_lb here, because we use Best Bound selection.
-				BranchNode(n);
-				
-				// Output to console.
-				if (tstream.RegisterAttempt()) tstream.WriteRow({STR(rolex.Peek()), STR(log.nodes_closed), STR(log.nodes_open), STR(z_lb), STR(z_ub), STR(spf->formulation->VariableCount())});
-			}
-			delete n;
+			ExploreTree(master.get(), &tstream);
+		}
+		else
+		{
+			// Each worker solves the relaxations on its own clone, spf is only modified to keep the global pool.
+			for (int i = workers.size(); i < worker_count; ++i) workers.push_back(CreateWorker(i, spf->Clone(), true));
+			parallel_for(worker_count, worker_count, [&] (int i, int w) { ExploreTree(workers[i].get(), &tstream); });
 		}
 		if (q.empty()) z_lb = z_ub;
 		
@@ -129,7 +194,7 @@ BCPExecutionLog BCP::Run(VRPSolution* solution)
 	if (z_lb != -INFTY) log.best_bound = z_lb;
 	
 	// If solution was found, assign it to the result.
-	if (z_ub != INFTY) solution->routes = spf->InterpretSolution(ub);
+	if (z_ub != INFTY) solution->routes = ub_routes;
 	if (z_ub != INFTY) solution->value = log.best_int_value;
 	
 	log.final_variable_count = spf->formulation->VariableCount();
@@ -138,36 +203,106 @@ BCPExecutionLog BCP::Run(VRPSolution* solution)
 	return log;
 }
 
-double BCP::EstimateBound(Node* node)
+void BCP::ExploreTree(Worker* worker, TableStream* tstream)
+{
+	unique_lock<mutex> lock(tree_mutex);
+	while (true)
+	{
+		// Wait until there is a node to branch, or no worker can add more nodes, or a limit was reached.
+		tree_cv.wait(lock, [&] { return !q.empty() || active_bounds.empty() || log.status != BCStatus::DidNotStart; });
+		if (q.empty() || log.status != BCStatus::DidNotStart) break;
+		if (log.nodes_closed >= node_limit) { log.status = BCStatus::NodeLimitReached; break; }
+		
+		// Pop node.
+		Node* n = q.top();
+		q.pop();
+		log.nodes_open--;
+		log.nodes_closed++;
+		
+		if (epsilon_bigger(z_ub, n->bound))
+		{
+			// Update z_lb here, because we use Best Bound selection (the nodes being branched are still open).
+			auto active = active_bounds.insert(n->bound);
+			z_lb = *active_bounds.begin();
+			lock.unlock();
+			BranchNode(n, worker);
+			lock.lock();
+			active_bounds.erase(active);
+			tree_cv.notify_all();
+			
+			// Output to console.
+			if (tstream->RegisterAttempt())
+			{
+				lock_guard<mutex> pool_lock(pool_mutex);
+				tstream->WriteRow({STR(rolex.Peek()), STR(log.nodes_closed), STR(log.nodes_open), STR(z_lb), STR(z_ub), STR(spf->formulation->VariableCount())});
+			}
+		}
+		delete n;
+	}
+	tree_cv.notify_all();
+}
+
+double BCP::EstimateBound(Node* node, SPF* relaxation, const LPSolver& solver)
 {
-	spf->SetForbiddenArcs(node->A);
-	auto lp_log = lp_solver.Solve(spf->formulation);
+	relaxation->SetForbiddenArcs(node->A);
+	relaxation->SetBasis(node->basis);
+	auto lp_log = solver.Solve(relaxation->formulation);
 	return lp_log.status == LPStatus::Optimum ? *lp_log.incumbent_value : INFTY;
 }
 
-void BCP::ProcessNode(Node* node)
+void BCP::ProcessNode(Node* node, Worker* worker)
 {
 	node_seq++;
-	spf->SetForbiddenArcs(node->A);
-	cg_solver.screen_output = node->index == 0 ? &clog : nullptr;
-	cg_solver.time_limit = time_limit - rolex.Peek();
-	auto cg_log = cg_solver.Solve(spf->formulation, {CGOption::IterationsInformation});
+	if (column_age_limit < INT_MAX) worker->spf->PurgeColumns(column_age_limit);
+	worker->spf->SetForbiddenArcs(node->A);
+	worker->separate_cuts = node->index == 0;
+	worker->cg_solver.screen_output = node->index == 0 ? &clog : nullptr;
+	worker->cg_solver.stabilization = dual_stabilization;
+	worker->cg_solver.smoothing_factor = smoothing_factor;
+	worker->cg_solver.gap_tolerance = cg_gap_tolerance;
+	
+	// Tree workers run concurrently, so each one solves its relaxations with a single CPLEX thread.
+	json config = node->index == 0 ? root_lp_config : lp_config;
+	if (worker->clone) config["CPX_PARAM_THREADS"] = 1;
+	ThreadReservation cplex_threads(requested_threads(config));
+	worker->lp_solver.config = reserved_config(config, cplex_threads);
+	{
+		lock_guard<mutex> lock(tree_mutex);
+		worker->cg_solver.time_limit = time_limit - rolex.Peek();
+		worker->cg_solver.cutoff = z_ub; // the node is pruned as soon as its Lagrangian bound exceeds the UB.
+	}
+	worker->spf->SetBasis(node->basis);
+	auto cg_log = worker->cg_solver.Solve(worker->spf->formulation, {CGOption::IterationsInformation, CGOption::Basis});
+	
+	// The relaxation might be infeasible because of the columns in the pool, in that case restore them and solve again.
+	if (cg_log.status == CGStatus::Infeasible && worker->spf->RestoreAllColumns() > 0)
+		cg_log = worker->cg_solver.Solve(worker->spf->formulation, {CGOption::IterationsInformation, CGOption::Basis});
+	
+	// An integer relaxation that the CG did not prove within the gap can not be branched, then finish the pricing.
+	if (cg_log.status == CGStatus::Optimum && cg_log.incumbent->IsInteger() &&
+		epsilon_bigger(cg_log.incumbent_value - cg_log.lagrangian_bound, cg_gap_tolerance))
+	{
+		worker->cg_solver.gap_tolerance = 0.0;
+		cg_log = worker->cg_solver.Solve(worker->spf->formulation, {CGOption::IterationsInformation, CGOption::Basis});
+	}
 	
+	lock_guard<mutex> lock(tree_mutex);
 	*log.lp_time += cg_log.lp_time;
 	
 	// Update node.
 	if (cg_log.status == CGStatus::Optimum)
 	{
-		node->bound = cg_log.incumbent_value;
-		node->opt = *cg_log.incumbent;
+		node->bound = cg_log.lagrangian_bound; // the master value, unless the CG stopped early within the gap.
+		node->opt = worker->spf->InterpretRelaxation(*cg_log.incumbent);
+		if (cg_log.basis.IsSet()) node->basis = worker->spf->InterpretBasis(*cg_log.basis);
 	}
 	
 	// Log some information if node is root.
 	if (node->index == 0)
 	{
 		log.root_log = cg_log;
-		log.root_variable_count = spf->formulation->VariableCount();
-		log.root_constraint_count = spf->formulation->ConstraintCount();
+		log.root_variable_count = worker->spf->formulation->VariableCount();
+		log.root_constraint_count = worker->spf->formulation->ConstraintCount();
 		if (cg_log.status == CGStatus::Optimum) log.root_lp_value = cg_log.incumbent_value;
 	}
 	
@@ -186,7 +321,7 @@ void BCP::ProcessNode(Node* node)
 	{
 		fail("Node relaxation can not be unbounded.");
 	}
-	else if (cg_log.status == CGStatus::Infeasible)
+	else if (cg_log.status == CGStatus::Infeasible || cg_log.status == CGStatus::Cutoff)
 	{
 		log.nodes_closed++;
 		delete node;
@@ -194,13 +329,16 @@ void BCP::ProcessNode(Node* node)
 	// Node was solved to optimality.
 	else
 	{
-		if (node->opt.IsInteger())
+		// An integer relaxation is a feasible solution, it solves the node only if its value is within the gap.
+		bool integer = cg_log.incumbent->IsInteger();
+		if (integer && z_ub > cg_log.incumbent_value) // Found a new optimum.
+		{
+			z_ub = cg_log.incumbent_value;
+			ub = *cg_log.incumbent;
+			ub_routes = worker->spf->InterpretSolution(ub);
+		}
+		if (integer && !epsilon_bigger(cg_log.incumbent_value - node->bound, cg_gap_tolerance))
 		{
-			if (z_ub > node->bound) // Found a new optimum.
-			{
-				z_ub = node->bound;
-				ub = node->opt;
-			}
 			log.nodes_closed++;
 			delete node;
 		}
@@ -217,116 +355,181 @@ void BCP::ProcessNode(Node* node)
 			q.push(node);
 		}
 	}
+	tree_cv.notify_all();
 }
 
-void BCP::BranchNode(Node* node)
+void BCP::BranchNode(Node* node, Worker* worker)
 {
 	Stopwatch rolex_branch(true);
 	
+	// Tree workers bring their clone up to date, so that the node basis (taken on another clone) fits in it.
+	if (worker->clone)
+	{
+		lock_guard<mutex> lock(pool_mutex);
+		worker->spf->Sync(*spf);
+	}
+	
 	// Calculate z[x_ij] values.
-	Matrix<double> x(D.VertexCount(), D.VertexCount(), 0.0);
-	for (auto& y_val: node->opt)
+	Matrix<double> x(vrp->D.VertexCount(), vrp->D.VertexCount(), 0.0);
+	for (auto& r_val: node->opt)
 	{
-		auto& r = spf->RouteOf(y_val.first);
-		for (int k = 1; k < (int)r.path.size()-2; ++k) x[r.path[k]][r.path[k+1]] += y_val.second;
+		auto& r = r_val.first;
+		for (int k = 1; k < (int)r.path.size()-2; ++k) x[r.path[k]][r.path[k+1]] += r_val.second;
 	}
 	
-	// Get STRONG_BRANCH_SIZE most violated x_ij (nearest to 0.5).
-	int STRONG_BRANCH_SIZE = 10;
+	// Get strong_branch_size most violated x_ij (nearest to 0.5).
 	vector<Arc> x_most; // arcs sorted by the violation.
-	for (Arc e: D.Arcs())
+	for (Arc e: vrp->D.Arcs())
 		if (epsilon_bigger(x[e.tail][e.head], 0.0) && epsilon_smaller(x[e.tail][e.head], 1.0))
 			x_most.push_back(e);
 	sort(x_most.begin(), x_most.end(), [&] (Arc e, Arc f) { return fabs(0.5-x[e.tail][e.head]) < fabs(0.5-x[f.tail][f.head]); });
-	while (x_most.size() > STRONG_BRANCH_SIZE) x_most.pop_back();
+	while (x_most.size() > strong_branch_size) x_most.pop_back();
 	
-	// Calculate all candidate estimate bounds and keep the best one.
-	vector<Node> best_candidate;
-	if (!x_most.empty())
+	// Calculate all candidate estimate bounds. When more than one thread is used, each thread solves the relaxations
+	// on its own clone of the SPF, because the LP solver is not thread-safe on a shared formulation. Tree workers
+	// already run concurrently, so they evaluate the candidates sequentially on their own SPF.
+	// A sequential evaluation gives CPLEX the threads of the LP configuration. The threads are released before the
+	// children are processed.
+	vector<Node> left(x_most.size()), right(x_most.size()); // children of each candidate.
 	{
-		double best_estimate = -INFTY;
-		
-		for (Arc e: x_most)
-		{
+		ThreadReservation branch_threads(worker->clone ? 1 : min(strong_branch_threads, (int)x_most.size()));
+		int thread_count = branch_threads.Count();
+		if (thread_count > 1) SyncPool(thread_count);
+		json config = lp_config;
+		if (thread_count > 1 || worker->clone) config["CPX_PARAM_THREADS"] = 1;
+		ThreadReservation cplex_threads(requested_threads(config));
+		vector<LPSolver> solvers(thread_count, worker->lp_solver); // solvers[w] = LP solver used by thread w.
+		for (auto& solver: solvers) solver.config = reserved_config(config, cplex_threads);
+		parallel_for(x_most.size(), thread_count, [&] (int candidate, int w) {
+			Arc e = x_most[candidate];
+			SPF* relaxation = thread_count > 1 ? spf_pool[w].get() : worker->spf;
 			vector<Arc> A = node->A; // infeasible arcs.
 			
 			// Left node (x_e = 0).
 			A.push_back(e);
-			Node left{node_seq+1, INFTY, A};
-			left.bound = EstimateBound(&left);
+			left[candidate] = Node{node_seq+1, INFTY, A, {}, node->basis};
+			left[candidate].bound = EstimateBound(&left[candidate], relaxation, solvers[w]);
 			
 			// Right node (x_e = 1).
 			A.pop_back();
-			for (Vertex j: D.Successors(e.tail)) if (j != e.head) A.push_back({e.tail, j});
-			for (Vertex i: D.Predecessors(e.head)) if (i != e.tail) A.push_back({i, e.head});
-			Node right{node_seq+2, INFTY, A};
-			right.bound = EstimateBound(&right);
-			
-			// If the candidate is the best so far, keep it.
-			if (min(left.bound, right.bound) > best_estimate)
-			{
-				best_estimate = min(left.bound, right.bound);
-				best_candidate = {};
-				if (left.bound < INFTY) best_candidate.push_back(left);
-				if (right.bound < INFTY) best_candidate.push_back(right);
-			}
+			for (Vertex j: vrp->D.Successors(e.tail)) if (j != e.head) A.push_back({e.tail, j});
+			for (Vertex i: vrp->D.Predecessors(e.head)) if (i != e.tail) A.push_back({i, e.head});
+			right[candidate] = Node{node_seq+2, INFTY, A, {}, node->basis};
+			right[candidate].bound = EstimateBound(&right[candidate], relaxation, solvers[w]);
+		});
+	}
+	
+	// Keep the best candidate (the first one in the violation order breaks ties).
+	vector<Node> best_candidate;
+	double best_estimate = -INFTY;
+	for (int i = 0; i < x_most.size(); ++i)
+	{
+		if (min(left[i].bound, right[i].bound) > best_estimate)
+		{
+			best_estimate = min(left[i].bound, right[i].bound);
+			best_candidate = {};
+			if (left[i].bound < INFTY) best_candidate.push_back(left[i]);
+			if (right[i].bound < INFTY) best_candidate.push_back(right[i]);
 		}
 	}
 	
-	*log.branching_time += rolex_branch.Pause();
+	{
+		lock_guard<mutex> lock(tree_mutex);
+		*log.branching_time += rolex_branch.Pause();
+	}
 	// Process new children to the queue.
 	for (Node& candidate: best_candidate)
-		ProcessNode(new Node(candidate));
+		ProcessNode(new Node(candidate), worker);
+}
+
+void BCP::SyncPool(int k)
+{
+	while (spf_pool.size() < k) spf_pool.emplace_back(nullptr);
+	parallel_for(k, k, [&] (int i, int worker) {
+		if (!spf_pool[i]) spf_pool[i].reset(spf->Clone());
+		else spf_pool[i]->Sync(*spf);
+	});
 }
 
 void BCP::FreezeHeuristic()
 {
 	BCSolver bc_solver;
 	bc_solver.time_limit = time_limit;
+	ThreadReservation cplex_threads(requested_threads(mip_config));
+	bc_solver.config = reserved_config(mip_config, cplex_threads);
 	auto bc_log = bc_solver.Solve(spf->formulation, {BCOption::BestIntSolution});
 	if (bc_log.status == BCStatus::Optimum && bc_log.best_int_value < z_ub)
 	{
 		z_ub = bc_log.best_int_value;
 		ub = *bc_log.best_int_solution;
+		ub_routes = spf->InterpretSolution(ub);
 	}
 }
 
-bool BCP::	SeparateCuts(const Valuation& z)
+int BCP::SeparateCuts(const Valuation& z, int k)
 {
+	int n = vrp->D.VertexCount();
+	
 	// Parse basis variables.
-	vector<VertexSet> z_visited; // z_visited[i] = vertices visited by basis variable i.
-	vector<double> z_values; // z_values[i] = value of basis variable i.
+	vector<VertexSet> z_visited; // z_visited[r] = vertices visited by basis variable r.
+	vector<double> z_values; // z_values[r] = value of basis variable r.
+	vector<vector<int>> routes_by_vertex(n); // routes_by_vertex[v] = { r : v \in z_visited[r] }.
+	Matrix<bool> share(n, n, false); // share[i][j] = i and j are visited by a fractional basis variable.
 	for (auto& y_val: z)
 	{
-		auto route = spf->RouteOf(y_val.first);
+		auto& route = spf->RouteOf(y_val.first);
+		int r = z_visited.size();
 		z_visited.push_back(create_bitset<MAX_N>(route.path));
 		z_values.push_back(y_val.second);
+		for (int a = 1; a < (int)route.path.size()-1; ++a)
+		{
+			routes_by_vertex[route.path[a]].push_back(r);
+			if (!epsilon_smaller(y_val.second, 1.0)) continue;
+			for (int b = 1; b < (int)route.path.size()-1; ++b) share[route.path[a]][route.path[b]] = true;
+		}
 	}
 	
-	// Brute force enumeration of all cuts, check the most violated.
-	double best_violation = 0.0;
-	SubsetRowCut best;
-	for (Vertex i = 1; i < D.VertexCount()-1; ++i)
-	{
-		for (Vertex j = i + 1; j < D.VertexCount() - 1; ++j)
+	// A cut can only be violated if two of its vertices share a fractional route (integer routes that visit two of its
+	// vertices can not be combined with another one). Evaluate those triples {i, j, k} concurrently, with one task for
+	// each i, keeping the violated ones.
+	struct Candidate { double violation; Vertex i, j, k; };
+	ThreadReservation separation_reservation(separation_threads);
+	int thread_count = separation_reservation.Count();
+	vector<vector<Candidate>> violated(thread_count); // violated[w] = violated cuts found by thread w.
+	parallel_for(n-2, thread_count, [&] (int task, int w) {
+		Vertex i = task + 1;
+		for (Vertex j = i + 1; j < n - 1; ++j)
 		{
-			for (Vertex k = j + 1; k < D.VertexCount() - 1; ++k)
+			for (Vertex k = j + 1; k < n - 1; ++k)
 			{
+				if (!share[i][j] && !share[i][k] && !share[j][k]) continue;
+				// Routes that visit at least two vertices of the cut, visit either i or j.
 				double violation = -1.0;
-				for (int r = 0; r < z_visited.size(); ++r)
-					if ((int)z_visited[r].test(i) + (int)z_visited[r].test(j) + (int)z_visited[r].test(k) >= 2)
-						violation += z_values[r];
-				if (epsilon_bigger(violation, best_violation))
-				{
-					best_violation = violation;
-					best = create_bitset<MAX_N>({i,j,k});
-				}
+				for (int r: routes_by_vertex[i]) if (z_visited[r].test(j) || z_visited[r].test(k)) violation += z_values[r];
+				for (int r: routes_by_vertex[j]) if (!z_visited[r].test(i) && z_visited[r].test(k)) violation += z_values[r];
+				if (epsilon_bigger(violation, 0.1)) violated[w].push_back({violation, i, j, k});
 			}
 		}
-	}
+	});
 	
-	// Add cut if found.
-	if (epsilon_bigger(best_violation, 0.1)) spf->AddCut(best);
-	return epsilon_bigger(best_violation, 0.1);
+	// Add the most violated cuts that are vertex disjoint (ties are broken by the vertices, for determinism).
+	vector<Candidate> candidates;
+	for (auto& v: violated) candidates.insert(candidates.end(), v.begin(), v.end());
+	sort(candidates.begin(), candidates.end(), [] (const Candidate& c1, const Candidate& c2) {
+		if (c1.violation != c2.violation) return c1.violation > c2.violation;
+		return make_tuple(c1.i, c1.j, c1.k) < make_tuple(c2.i, c2.j, c2.k);
+	});
+	VertexSet used;
+	vector<SubsetRowCut> cuts;
+	for (auto& c: candidates)
+	{
+		if (cuts.size() >= k) break;
+		SubsetRowCut cut = create_bitset<MAX_N>({c.i, c.j, c.k});
+		if (intersection(cut, used).any()) continue;
+		cuts.push_back(cut);
+		used |= cut;
+	}
+	spf->AddCuts(cuts);
+	return cuts.size();
 }
-} // namespace networks2019
\ No newline at end of file
+} // namespace networks2019
@@ -12,6 +12,14 @@ using namespace nlohmann;
 
 namespace networks2019
 {
+double PricingProblem::ReducedCost(const Route& r) const
+{
+	VertexSet V = create_bitset<MAX_N>(r.path);
+	double reduced_cost = r.duration - sum<Vertex>(r.path, [&] (Vertex v) { return P[v]; });
+	for (int i = 0; i < S.size(); ++i) if (intersection(S[i], V).count() >= 2) reduced_cost -= sigma[i];
+	return reduced_cost;
+}
+
 void PricingProblem::Print(std::ostream& os) const
 {
 	os << json(*this);
@@ -6,6 +6,8 @@
 
 #include "bcp/spf.h"
 
+#include <algorithm>
+
 #include "bcp/pricing_problem.h"
 
 using namespace std;
@@ -24,6 +26,7 @@ SPF::SPF(int n) : n(n)
 	// Init structures.
 	omega_by_arc = Matrix<vector<int>>(n, n);
 	forbidden_arcs = {};
+	is_forbidden = Matrix<bool>(n, n, false);
 }
 
 SPF::~SPF()
@@ -33,59 +36,226 @@ SPF::~SPF()
 
 void SPF::AddRoute(const Route& r)
 {
-	// Add route r to Omega.
-	int j = omega.size();
-	omega.push_back(r);
-	
-	// Add variable y_j to the formulation.
-	Variable y_j = formulation->AddVariable("y_" + STR(j), VariableDomain::Binary, 0.0, INFTY);
-	y.push_back(y_j);
-	
-	// Set coefficient 1.0 in vertices visited.
-	for (int k = 1; k < (int)r.path.size()-1; ++k) formulation->SetConstraintCoefficient(r.path[k], y_j, 1.0);
-	
-	// Set duration(r) as c_j in the objective function.
-	formulation->SetObjectiveCoefficient(y_j, r.duration);
-	
-	// Add the route to the structure indexed by arcs.
-	for (int k = 0; k < (int)r.path.size()-1; ++k) omega_by_arc[r.path[k]][r.path[k+1]].push_back(j);
+	AddRoutes({r});
+}
+
+void SPF::AddRoutes(const vector<Route>& routes)
+{
+	vector<int> ids;
+	for (auto& r: routes)
+	{
+		// Add route r to Omega.
+		int j = omega.size();
+		omega.push_back(r);
+		visited.push_back(create_bitset<MAX_N>(r.path));
+		y.push_back(Variable());
+		in_lp.push_back(false);
+		age.push_back(0);
+		forbidden_count.push_back(0);
+		fixed.push_back(false);
+		ids.push_back(j);
+		
+		// Add the route to the structure indexed by arcs.
+		for (int k = 0; k < (int)r.path.size()-1; ++k)
+		{
+			omega_by_arc[r.path[k]][r.path[k+1]].push_back(j);
+			if (is_forbidden[r.path[k]][r.path[k+1]]) forbidden_count[j]++;
+		}
+	}
+	AddColumns(ids);
+}
+
+void SPF::AddColumns(const vector<int>& ids)
+{
+	vector<Column> columns;
+	for (int j: ids)
+	{
+		const Route& r = omega[j];
+		
+		// Variable y_j is fixed to 0 if r uses a forbidden arc (e.g. it was found in another node).
+		fixed[j] = forbidden_count[j] > 0;
+		
+		// Set duration(r) as c_j in the objective function.
+		Column y_j{"y_" + STR(j), VariableDomain::Binary, 0.0, fixed[j] ? 0.0 : INFTY, r.duration, {}};
+		
+		// Set coefficient 1.0 in vertices visited.
+		for (int k = 1; k < (int)r.path.size()-1; ++k) y_j.coefficients.push_back({r.path[k], 1.0});
+		
+		// Set cuts coefficients.
+		for (int i = 0; i < cuts.size(); ++i)
+			if (intersection(cuts[i], visited[j]).count() >= 2)
+				y_j.coefficients.push_back({n+i, 1.0});
+		
+		columns.push_back(y_j);
+	}
 	
-	// Update cuts coefficients.
-	for (int i = 0; i < cuts.size(); ++i)
-		if (sum<Vertex>(r.path, [&] (Vertex v) { return cuts[i].test(v) ? 1 : 0; }) >= 2)
-			formulation->SetConstraintCoefficient(n+i, y[j], 1.0);
+	// Add all the columns at once.
+	auto variables = formulation->AddColumns(columns);
+	for (int k = 0; k < ids.size(); ++k)
+	{
+		y[ids[k]] = variables[k];
+		in_lp[ids[k]] = true;
+		age[ids[k]] = 0;
+		column_route.push_back(ids[k]);
+	}
 }
 
 void SPF::AddCut(const SubsetRowCut& cut)
 {
-	int i = cuts.size(); // index of this new cut.
-	cuts.push_back(cut);
-	formulation->AddConstraint(Expression().LEQ(1.0)); // Add row for cut. floor(n/k) = floor(3/2) = 1.
-	
-	// Update routes' coefficient that visit at least 2 customers in the cut.
- 	for (int j = 0; j < omega.size(); ++j)
-		if (sum<Vertex>(omega[j].path, [&] (Vertex v) { return cut.test(v) ? 1 : 0; }) >= 2)
-			formulation->SetConstraintCoefficient(n+i, y[j], 1.0);
+	AddCuts({cut});
+}
+
+void SPF::AddCuts(const vector<SubsetRowCut>& new_cuts)
+{
+	// Add a row for each cut (floor(n/k) = floor(3/2) = 1), with coefficient 1.0 for the routes in the LP that visit at
+	// least 2 customers in the cut (the ones in the pool get it when restored).
+	vector<Row> rows;
+	for (auto& cut: new_cuts)
+	{
+		Row row{Constraint::LessEqual, 1.0, {}};
+		for (int j: column_route)
+			if (intersection(cut, visited[j]).count() >= 2)
+				row.coefficients.push_back({y[j].Index(), 1.0});
+		rows.push_back(row);
+		cuts.push_back(cut);
+	}
+	formulation->AddRows(rows);
+}
+
+double SPF::ReducedCost(int j, const vector<double>& duals) const
+{
+	const Route& r = omega[j];
+	double reduced_cost = r.duration;
+	for (int k = 1; k < (int)r.path.size()-1; ++k) reduced_cost -= duals[r.path[k]];
+	for (int i = 0; i < cuts.size(); ++i)
+		if (intersection(cuts[i], visited[j]).count() >= 2)
+			reduced_cost -= duals[n+i];
+	return reduced_cost;
+}
+
+void SPF::UpdateColumnAges(const vector<double>& duals)
+{
+	for (int j: column_route)
+		age[j] = epsilon_bigger(ReducedCost(j, duals), 0.0) ? age[j] + 1 : 0;
+}
+
+int SPF::PurgeColumns(int max_age)
+{
+	vector<Variable> purged;
+	vector<int> remaining;
+	for (int j: column_route)
+	{
+		if (age[j] >= max_age) { purged.push_back(y[j]); in_lp[j] = false; }
+		else remaining.push_back(j);
+	}
+	formulation->RemoveVariables(purged);
+	column_route = remaining;
+	return purged.size();
+}
+
+int SPF::RestoreColumns(const vector<double>& duals)
+{
+	vector<int> restored;
+	for (int j = 0; j < omega.size(); ++j)
+	{
+		if (in_lp[j] || forbidden_count[j] > 0 || !epsilon_smaller(ReducedCost(j, duals), 0.0)) continue;
+		restored.push_back(j);
+	}
+	AddColumns(restored);
+	return restored.size();
+}
+
+int SPF::RestoreAllColumns()
+{
+	vector<int> restored;
+	for (int j = 0; j < omega.size(); ++j)
+		if (!in_lp[j])
+			restored.push_back(j);
+	AddColumns(restored);
+	return restored.size();
+}
+
+SPF* SPF::Clone() const
+{
+	SPF* clone = new SPF(n);
+	clone->Sync(*this);
+	return clone;
+}
+
+void SPF::Sync(const SPF& spf)
+{
+	AddCuts(vector<SubsetRowCut>(spf.cuts.begin() + cuts.size(), spf.cuts.end()));
+	AddRoutes(vector<Route>(spf.omega.begin() + omega.size(), spf.omega.end()));
 }
 
 void SPF::SetForbiddenArcs(const vector<Arc>& A)
 {
-	// Restore previously forbidden arcs.
+	// Find the arcs that stop being forbidden and the ones that start being forbidden.
+	vector<Arc> new_arcs = A;
+	sort(new_arcs.begin(), new_arcs.end());
+	new_arcs.erase(unique(new_arcs.begin(), new_arcs.end()), new_arcs.end());
+	vector<Arc> allowed, forbidden;
 	for (Arc e: forbidden_arcs)
+	{
+		if (!is_forbidden[e.tail][e.head] || binary_search(new_arcs.begin(), new_arcs.end(), e)) continue;
+		is_forbidden[e.tail][e.head] = false;
+		allowed.push_back(e);
+	}
+	for (Arc e: new_arcs)
+	{
+		if (is_forbidden[e.tail][e.head]) continue;
+		is_forbidden[e.tail][e.head] = true;
+		forbidden.push_back(e);
+	}
+	
+	// Update the number of forbidden arcs of the routes that use them.
+	vector<int> touched;
+	for (Arc e: allowed)
 		for (int j: omega_by_arc[e.tail][e.head])
-			formulation->SetVariableBound(y[j], 0.0, INFTY);
-
-	// All routes with forbidden arcs must be set to 0.
-	for (Arc e: A)
+			forbidden_count[j]--, touched.push_back(j);
+	for (Arc e: forbidden)
 		for (int j: omega_by_arc[e.tail][e.head])
-			formulation->SetVariableBound(y[j], 0.0, 0.0);
+			forbidden_count[j]++, touched.push_back(j);
+	
+	// Only update the columns in the LP whose status changed: y_j = 0 iff route j contains a forbidden arc.
+	vector<Variable> changed;
+	vector<double> lower_bounds, upper_bounds;
+	for (int j: touched)
+	{
+		if (!in_lp[j] || fixed[j] == (forbidden_count[j] > 0)) continue;
+		fixed[j] = forbidden_count[j] > 0;
+		changed.push_back(y[j]);
+		lower_bounds.push_back(0.0);
+		upper_bounds.push_back(fixed[j] ? 0.0 : INFTY);
+	}
+	formulation->SetVariableBounds(changed, lower_bounds, upper_bounds);
 
 	forbidden_arcs = A;
 }
 
 const Route& SPF::RouteOf(const Variable& variable) const
 {
-	return omega[variable.Index()];
+	return omega[column_route[variable.Index()]];
+}
+
+int SPF::RouteCount() const
+{
+	return omega.size();
+}
+
+void SPF::SetBasis(const SPFBasis& basis)
+{
+	if (basis.constraint_status.empty()) return;
+	Basis lp_basis;
+	lp_basis.variable_status.assign(column_route.size(), Basis::AtLower);
+	lp_basis.constraint_status = basis.constraint_status;
+	for (auto& route_status: basis.routes)
+	{
+		int j = route_status.first;
+		if (j >= omega.size() || !in_lp[j]) return;
+		lp_basis.variable_status[y[j].Index()] = route_status.second;
+	}
+	formulation->SetBasis(lp_basis);
 }
 
 PricingProblem SPF::InterpretDuals(const vector<double>& duals) const
@@ -108,7 +278,24 @@ PricingProblem SPF::InterpretDuals(const vector<double>& duals) const
 vector<Route> SPF::InterpretSolution(const Valuation& z) const
 {
 	vector<Route> solution;
-	for (auto& y_value: z) solution.push_back(omega[y_value.first.Index()]);
+	for (auto& y_value: z) solution.push_back(RouteOf(y_value.first));
 	return solution;
 }
+
+vector<pair<Route, double>> SPF::InterpretRelaxation(const Valuation& z) const
+{
+	vector<pair<Route, double>> relaxation;
+	for (auto& y_value: z) relaxation.push_back({RouteOf(y_value.first), y_value.second});
+	return relaxation;
+}
+
+SPFBasis SPF::InterpretBasis(const Basis& basis) const
+{
+	SPFBasis spf_basis;
+	spf_basis.constraint_status = basis.constraint_status;
+	for (int k = 0; k < basis.variable_status.size(); ++k)
+		if (basis.variable_status[k] != Basis::AtLower)
+			spf_basis.routes.push_back({column_route[k], basis.variable_status[k]});
+	return spf_basis;
+}
 } // namespace networks2019
\ No newline at end of file
@@ -0,0 +1,311 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "instance_reader.h"
+
+#include <set>
+
+using namespace std;
+using namespace goc;
+using namespace nlohmann;
+
+namespace networks2019
+{
+namespace
+{
+// Returns: the element v[i], v is extended if it does not have it.
+template<typename T>
+T& element(vector<T>& v, int i)
+{
+	if ((int)v.size() <= i) v.resize(i+1);
+	return v[i];
+}
+
+// Returns: the matrix with the cells of the rows (the missing ones have default values).
+template<typename T>
+Matrix<T> to_matrix(vector<vector<T>>& rows, int row_count, int column_count)
+{
+	Matrix<T> M(row_count, column_count);
+	for (int i = 0; i < min(row_count, (int)rows.size()); ++i)
+		move(rows[i].begin(), rows[i].begin() + min(column_count, (int)rows[i].size()), M[i]);
+	return M;
+}
+
+// Position of the current value inside an open object or array of the document.
+struct Step
+{
+	bool in_array; // if the value is inside an array (otherwise it is inside an object).
+	string key; // key of the value inside the object.
+	int index; // index of the value inside the array.
+};
+
+// Handler that keeps the path of the current value, sends the numbers of the typed attributes to Value() and builds the
+// JSON of the remaining attributes of the root object.
+class InstanceHandler : public JSONHandler
+{
+public:
+	explicit InstanceHandler(json* attributes) : attributes_(attributes)
+	{
+	
+	}
+	
+	virtual void Null()
+	{
+		if (StartValue()) { attribute_.Null(); EndAttribute(); }
+	}
+	
+	virtual void Boolean(bool value)
+	{
+		if (StartValue()) { attribute_.Boolean(value); EndAttribute(); }
+	}
+	
+	virtual void Number(double value)
+	{
+		if (StartValue()) { attribute_.Number(value); EndAttribute(); }
+		else Value(value);
+	}
+	
+	virtual void Integer(long long value)
+	{
+		if (StartValue()) { attribute_.Integer(value); EndAttribute(); }
+		else Value(value);
+	}
+	
+	virtual void String(const string& value)
+	{
+		if (StartValue()) { attribute_.String(value); EndAttribute(); }
+	}
+	
+	virtual void StartObject()
+	{
+		if (!path_.empty() && StartValue()) attribute_.StartObject();
+		else path_.push_back({false, "", -1});
+	}
+	
+	virtual void Key(const string& key)
+	{
+		if (in_attribute_) attribute_.Key(key);
+		else path_.back().key = key;
+	}
+	
+	virtual void EndObject()
+	{
+		if (in_attribute_) { attribute_.EndObject(); EndAttribute(); }
+		else path_.pop_back();
+	}
+	
+	virtual void StartArray()
+	{
+		if (StartValue()) attribute_.StartArray();
+		else path_.push_back({true, "", -1});
+	}
+	
+	virtual void EndArray()
+	{
+		if (in_attribute_) { attribute_.EndArray(); EndAttribute(); }
+		else path_.pop_back();
+	}
+
+protected:
+	// Returns: if the attribute of the root object with the given key is stored directly by the handler.
+	virtual bool IsTyped(const string& key) const = 0;
+	
+	// Receives a number of a typed attribute, its position is given by the current path.
+	virtual void Value(double value) = 0;
+	
+	// Returns: the number of objects and arrays that contain the current value (1 for the attributes of the root).
+	int Depth() const
+	{
+		return path_.size();
+	}
+	
+	// Returns: the key of the value inside the k-th object that contains it (0 is the root).
+	const string& KeyAt(int k) const
+	{
+		return path_[k].key;
+	}
+	
+	// Returns: the index of the value inside the k-th array that contains it.
+	int IndexAt(int k) const
+	{
+		return path_[k].index;
+	}
+
+private:
+	json* attributes_; // remaining attributes of the root object.
+	vector<Step> path_; // position of the current value inside each open object or array.
+	JSONDocumentBuilder attribute_; // document of the untyped attribute being read.
+	bool in_attribute_ = false; // if the current value is inside an untyped attribute.
+	
+	// Updates the path for a new value (other than the root object).
+	// Returns: if the value belongs to an untyped attribute, and must be sent to attribute_.
+	// Exception: if the value is the root, because the root must be an object.
+	bool StartValue()
+	{
+		if (in_attribute_) return true;
+		if (path_.empty()) fail("The instance must be a JSON object.");
+		if (path_.back().in_array) ++path_.back().index;
+		if (path_.size() == 1 && !IsTyped(path_[0].key))
+		{
+			attribute_ = JSONDocumentBuilder();
+			in_attribute_ = true;
+		}
+		return in_attribute_;
+	}
+	
+	// Stores the untyped attribute in the attributes once it is complete.
+	void EndAttribute()
+	{
+		if (!attribute_.Done()) return;
+		(*attributes_)[path_[0].key] = move(attribute_.document);
+		in_attribute_ = false;
+	}
+};
+
+// Stores the typed attributes of a VRP instance.
+class VRPInstanceHandler : public InstanceHandler
+{
+public:
+	int vertex_count = 0; // digraph.vertex_count.
+	vector<Arc> arcs; // arcs of the digraph, in the order of the adjacency matrix.
+	vector<vector<PWLFunction>> tau; // rows of the travel_times read so far.
+	vector<Interval> tw; // time_windows.
+	vector<TimeUnit> s; // service_times.
+	vector<CapacityUnit> q; // demands.
+	vector<vector<double>> distances; // rows of the distances read so far.
+	vector<vector<int>> clusters; // rows of the clusters read so far.
+	vector<vector<double>> cluster_speeds; // cluster_speeds.
+	vector<Interval> speed_zones; // speed_zones.
+	
+	using InstanceHandler::InstanceHandler;
+
+protected:
+	virtual bool IsTyped(const string& key) const
+	{
+		static const set<string> TYPED = {"digraph", "travel_times", "time_windows", "service_times", "demands",
+			"distances", "clusters", "cluster_speeds", "speed_zones"};
+		return TYPED.count(key) > 0;
+	}
+	
+	virtual void Value(double value)
+	{
+		const string& attribute = KeyAt(0);
+		int depth = Depth();
+		if (attribute == "digraph")
+		{
+			if (depth == 2 && KeyAt(1) == "vertex_count") vertex_count = value;
+			else if (depth == 4 && KeyAt(1) == "arcs" && value == 1) arcs.push_back({IndexAt(2), IndexAt(3)});
+		}
+		else if (attribute == "travel_times" && depth == 6)
+		{
+			// travel_times[i][j][piece][point][coordinate], the piece is added when its last coordinate is read.
+			int point = IndexAt(4), coordinate = IndexAt(5);
+			piece_[point * 2 + coordinate] = value;
+			if (point == 1 && coordinate == 1)
+			{
+				PWLFunction& f = element(element(tau, IndexAt(1)), IndexAt(2));
+				f.AddPiece(LinearFunction(Point2D(piece_[0], piece_[1]), Point2D(piece_[2], piece_[3])));
+			}
+		}
+		else if (attribute == "time_windows" && depth == 3)
+		{
+			Interval& tw_i = element(tw, IndexAt(1));
+			(IndexAt(2) == 0 ? tw_i.left : tw_i.right) = value;
+		}
+		else if (attribute == "service_times" && depth == 2) element(s, IndexAt(1)) = value;
+		else if (attribute == "demands" && depth == 2) element(q, IndexAt(1)) = value;
+		else if (attribute == "distances" && depth == 3) element(element(distances, IndexAt(1)), IndexAt(2)) = value;
+		else if (attribute == "clusters" && depth == 3) element(element(clusters, IndexAt(1)), IndexAt(2)) = value;
+		else if (attribute == "cluster_speeds" && depth == 3)
+			element(element(cluster_speeds, IndexAt(1)), IndexAt(2)) = value;
+		else if (attribute == "speed_zones" && depth == 3)
+		{
+			Interval& zone = element(speed_zones, IndexAt(1));
+			(IndexAt(2) == 0 ? zone.left : zone.right) = value;
+		}
+	}
+
+private:
+	double piece_[4]; // coordinates of the points of the travel time piece being read.
+};
+
+// Stores the graph of a TDCARP instance.
+class TDCARPInstanceHandler : public InstanceHandler
+{
+public:
+	int vertex_count = 0; // graph.vertex_count.
+	vector<TDCARPEdge> edges; // graph.edges.
+	
+	using InstanceHandler::InstanceHandler;
+
+protected:
+	virtual bool IsTyped(const string& key) const
+	{
+		return key == "graph";
+	}
+	
+	virtual void Value(double value)
+	{
+		int depth = Depth();
+		if (depth == 2 && KeyAt(1) == "vertex_count") vertex_count = value;
+		if (depth < 4 || KeyAt(1) != "edges") return;
+		// graph.edges[k].attribute or graph.edges[k].travel_time[p].attribute.
+		TDCARPEdge& e = element(edges, IndexAt(2));
+		const string& attribute = KeyAt(3);
+		if (depth == 4)
+		{
+			if (attribute == "tail") e.tail = value;
+			else if (attribute == "head") e.head = value;
+			else if (attribute == "distance") e.distance = value;
+			else if (attribute == "demand") e.demand = value;
+		}
+		else if (depth == 6 && attribute == "travel_time")
+		{
+			int p = IndexAt(4);
+			if (KeyAt(5) == "piece_end") element(e.piece_ends, p) = value;
+			else if (KeyAt(5) == "speed") element(e.speeds, p) = value;
+		}
+	}
+};
+}
+
+VRPInstanceBuilder read_vrp_instance(istream& is, json* attributes)
+{
+	*attributes = json::object();
+	VRPInstanceHandler handler(attributes);
+	parse_json_stream(is, &handler);
+	
+	int n = handler.vertex_count;
+	VRPInstanceBuilder builder;
+	builder.D = Digraph(n);
+	for (Arc e: handler.arcs) builder.D.AddArc(e);
+	builder.tw = move(handler.tw);
+	builder.s = move(handler.s);
+	builder.q = move(handler.q);
+	if (!handler.tau.empty()) builder.tau = to_matrix(handler.tau, n, n);
+	if (!handler.distances.empty())
+		builder.distances = to_matrix(handler.distances, handler.distances.size(), handler.distances[0].size());
+	if (!handler.clusters.empty())
+		builder.clusters = to_matrix(handler.clusters, handler.clusters.size(), handler.clusters[0].size());
+	builder.cluster_speeds = move(handler.cluster_speeds);
+	builder.speed_zones = move(handler.speed_zones);
+	builder.SetAttributes(*attributes);
+	return builder;
+}
+
+TDCARPInstance read_tdcarp_instance(istream& is, json* attributes)
+{
+	*attributes = json::object();
+	TDCARPInstanceHandler handler(attributes);
+	parse_json_stream(is, &handler);
+	
+	TDCARPInstance instance;
+	instance.vertex_count = handler.vertex_count;
+	instance.edges = move(handler.edges);
+	instance.SetAttributes(*attributes);
+	return instance;
+}
+} // namespace networks2019
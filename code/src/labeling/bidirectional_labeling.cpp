@@ -17,45 +17,6 @@ namespace networks2019
 {
 namespace
 {
-// Reverses a VRP instance.
-// o' := d
-// d' := o
-// D' := reverse(D)
-// tw'(v) := [T-b(v), T-a(v)]
-// arr'_vu(t) := T-dep_uv(T-t)
-VRPInstance reverse_instance(const VRPInstance& vrp)
-{
-	VRPInstance r = vrp;
-	swap(r.o, r.d);
-	r.D = vrp.D.Reverse();
-	for (Vertex v: r.D.Vertices()) r.tw[v] = {vrp.T - vrp.tw[v].right, vrp.T - vrp.tw[v].left};
-	for (Vertex u: vrp.D.Vertices())
-	{
-		for (Vertex v: vrp.D.Successors(u))
-		{
-			// Compute reverse travel functions.
-			r.arr[v][u] = vrp.T - vrp.dep[u][v].Compose(vrp.T - PWLFunction::IdentityFunction({0.0, vrp.T}));
-			r.arr[v][u] = Min(PWLFunction::ConstantFunction(min(img(r.arr[v][u])), {min(r.tw[v]), min(dom(r.arr[v][u]))}), r.arr[v][u]);
-			r.tau[v][u] = r.arr[v][u] - PWLFunction::IdentityFunction({0.0, vrp.T});
-			r.dep[v][u] = r.arr[v][u].Inverse();
-			r.pretau[v][u] = PWLFunction::IdentityFunction(dom(r.dep[v][u])) - r.dep[v][u];
-		}
-	}
-	// Add travel functions for (i, i) (for boundary reasons).
-	for (Vertex u: r.D.Vertices())
-	{
-		r.tau[u][u] = r.pretau[u][u] = PWLFunction::ConstantFunction(0.0, r.tw[u]);
-		r.dep[u][u] = r.arr[u][u] = PWLFunction::IdentityFunction(r.tw[u]);
-	}
-	// Set LDT.
-	for (Vertex i: r.D.Vertices())
-	{
-		vector<TimeUnit> LDT_i = compute_latest_departure_time(r.D, i, r.tw[i].right, [&] (Vertex u, Vertex v, double tf) { return r.DepartureTime({u,v}, tf); });
-		for (Vertex k: r.D.Vertices()) r.LDT[k][i] = LDT_i[k];
-	}
-	return r;
-}
-
 PricingProblem reverse_pricing_problem(const PricingProblem& pp)
 {
 	PricingProblem rpp = pp;
@@ -65,8 +26,12 @@ PricingProblem reverse_pricing_problem(const PricingProblem& pp)
 }
 }
 
-BidirectionalLabeling::BidirectionalLabeling(const VRPInstance& vrp)
-	: vrp_(vrp), lbl_{MonodirectionalLabeling(vrp_), MonodirectionalLabeling(reverse_instance(vrp_))}
+BidirectionalLabeling::BidirectionalLabeling(shared_ptr<const VRPInstance> vrp)
+	: BidirectionalLabeling(vrp, make_shared<const VRPInstance>(reverse_instance(*vrp)))
+{ }
+
+BidirectionalLabeling::BidirectionalLabeling(shared_ptr<const VRPInstance> vrp, shared_ptr<const VRPInstance> reverse_vrp)
+	: vrp_(vrp), lbl_{MonodirectionalLabeling(vrp), MonodirectionalLabeling(reverse_vrp)}
 {
 	solution_limit = INT_MAX;
 	time_limit = Duration::Max();
@@ -83,17 +48,15 @@ BLBExecutionLog BidirectionalLabeling::Run(const PricingProblem& pricing_problem
 {
 	// Clean solution pool.
 	S.clear();
-	M[0] = M[1] = vector<MonodirectionalLabeling::DemandLevel>(vrp_.D.VertexCount());
+	M[0] = M[1] = vector<MonodirectionalLabeling::DemandLevel>(vrp_->D.VertexCount());
 	
 	// Set pricing problem.
-	vrp_.D.AddArcs(pp_.A); // Add previously forbidden arcs.
 	pp_ = pricing_problem;
-	vrp_.D.RemoveArcs(pp_.A); // Remove pricing problem forbidden arcs.
 	
 	// Init forward and backward labeling.
 	lbl_[0].SetProblem(pp_);
 	lbl_[1].SetProblem(reverse_pricing_problem(pp_));
-	lbl_[0].t_m = lbl_[1].t_m = symmetric ? vrp_.T / 2 : vrp_.T;
+	lbl_[0].t_m = lbl_[1].t_m = symmetric ? vrp_->T / 2 : vrp_->T;
 	
 	lbl_[0].partial = lbl_[1].partial = partial;
 	lbl_[0].relax_elementary_check = lbl_[1].relax_elementary_check = relax_elementary_check;
@@ -155,12 +118,12 @@ BLBExecutionLog BidirectionalLabeling::Run(const PricingProblem& pricing_problem
 			
 			// Check if any full route was generated.
 			for (Label* l: P)
-				if (d == 0 && l->v == vrp_.d && epsilon_smaller(l->min_cost, 0.0))
+				if (d == 0 && l->v == vrp_->d && epsilon_smaller(l->min_cost, 0.0))
 					AddSolution(l->Path(), min(img(l->duration)));
 			
 			// Update t_m.
-			if (q[d].empty()) lbl_[d].t_m = vrp_.T - lbl_[od].t_m; // If d has no more labels in the queue, the middle is t_m
-			else lbl_[od].t_m = min(lbl_[od].t_m, max(vrp_.T-lbl_[d].t_m, vrp_.T-q[d].top().makespan));
+			if (q[d].empty()) lbl_[d].t_m = vrp_->T - lbl_[od].t_m; // If d has no more labels in the queue, the middle is t_m
+			else lbl_[od].t_m = min(lbl_[od].t_m, max(vrp_->T-lbl_[d].t_m, vrp_->T-q[d].top().makespan));
 			
 			// Check if any label was processed.
 			processed |= !P.empty();
@@ -171,7 +134,7 @@ BLBExecutionLog BidirectionalLabeling::Run(const PricingProblem& pricing_problem
 		{
 			tstream.WriteRow({STR(rolex.Peek()), STR(mlb_log[0]->time), STR(mlb_log[1]->time),
 					 STR(mlb_log[0]->processed_count), STR(mlb_log[1]->processed_count), STR(S.size()),
-					 STR(lbl_[0].t_m), STR(vrp_.T-lbl_[1].t_m), STR(q[0].size()), STR(q[1].size())});
+					 STR(lbl_[0].t_m), STR(vrp_->T-lbl_[1].t_m), STR(q[0].size()), STR(q[1].size())});
 		}
 	}
 	
@@ -192,7 +155,7 @@ BLBExecutionLog BidirectionalLabeling::Run(const PricingProblem& pricing_problem
 	{
 		Route& r = V_r.second;
 		// Compute r actual duration.
-		R->push_back(vrp_.BestDurationRoute(r.path));
+		R->push_back(vrp_->BestDurationRoute(r.path));
 	}
 	
 	return log;
@@ -200,11 +163,11 @@ BLBExecutionLog BidirectionalLabeling::Run(const PricingProblem& pricing_problem
 
 void BidirectionalLabeling::IterativeMerge(Label* l, const MonodirectionalLabeling::DominanceStructure& L)
 {
-	TimeUnit T = vrp_.T;
+	TimeUnit T = vrp_->T;
 	for (auto& demand_entry : L[l->v])
 	{
 		if (S.size() >= solution_limit) break; // Do not exceed solution limit.
-		if (epsilon_bigger(demand_entry.first+l->q-vrp_.q[l->v], vrp_.Q)) break;
+		if (epsilon_bigger(demand_entry.first+l->q-vrp_->q[l->v], vrp_->Q)) break;
 		for (auto& m: demand_entry.second)
 		{
 			if (S.size() >= solution_limit) break; // Do not exceed solution limit.
@@ -216,11 +179,11 @@ void BidirectionalLabeling::IterativeMerge(Label* l, const MonodirectionalLabeli
 
 void BidirectionalLabeling::LastArcMerge(LBQueue& qf, const MonodirectionalLabeling::DominanceStructure& Lb)
 {
-	TimeUnit T = vrp_.T;
+	TimeUnit T = vrp_->T;
 	
 	// Create M_ijq structure.
-	Matrix<VectorMap<CapacityUnit, vector<Label*>>> M(vrp_.D.VertexCount(), vrp_.D.VertexCount());
-	for (Vertex v: vrp_.D.Vertices())
+	Matrix<VectorMap<CapacityUnit, vector<Label*>>> M(vrp_->D.VertexCount(), vrp_->D.VertexCount());
+	for (Vertex v: vrp_->D.Vertices())
 		for (auto& entry: Lb[v])
 			for (auto& m: entry.second)
 				insert_sorted(M[m->v][m->parent->v].Insert(entry.first, {}), m, [] (Label* m1, Label* m2) { return m1->min_cost < m2->min_cost; });
@@ -234,7 +197,7 @@ void BidirectionalLabeling::LastArcMerge(LBQueue& qf, const MonodirectionalLabel
 		
 		for (auto& entry: M[ll.parent->v][ll.v])
 		{
-			if (epsilon_bigger(entry.first + l->q - vrp_.q[l->v], vrp_.Q)) break;
+			if (epsilon_bigger(entry.first + l->q - vrp_->q[l->v], vrp_->Q)) break;
 			if (S.size() >= solution_limit) break; // Do not exceed solution limit.
 			for (Label* m: entry.second)
 			{
@@ -248,7 +211,7 @@ void BidirectionalLabeling::LastArcMerge(LBQueue& qf, const MonodirectionalLabel
 
 void BidirectionalLabeling::Merge(Label* l, Label* m)
 {
-	TimeUnit T = vrp_.T;
+	TimeUnit T = vrp_->T;
 	
 	if (epsilon_bigger(min(l->rw), T-min(m->rw))) return;
 	if (intersection(l->S, m->S) != create_bitset<MAX_N>({l->v})) return;
@@ -274,7 +237,7 @@ void BidirectionalLabeling::Merge(Label* l, Label* m)
 	// Merge l and m paths.
 	r.path = l->Path();
 	for (Label* x = m->parent; x->parent != nullptr; x = x->parent) r.path.push_back(x->v);
-	if (r.path[0] != vrp_.o) r.path = reverse(r.path);
+	if (r.path[0] != vrp_->o) r.path = reverse(r.path);
 	
 	// We have a negative reduced cost route r.
 	AddSolution(r.path, r.duration);
@@ -286,4 +249,49 @@ void BidirectionalLabeling::AddSolution(const goc::GraphPath& p, double min_dura
 	if (!includes_key(S, V)) S[V] = Route({}, 0.0, INFTY);
 	if (S[V].duration > min_duration) S[V] = Route(p, 0.0, min_duration);
 }
+
+VRPInstance reverse_instance(const VRPInstance& vrp)
+{
+	int n = vrp.D.VertexCount();
+	VRPInstance r;
+	r.D = vrp.D.Reverse();
+	r.o = vrp.d;
+	r.d = vrp.o;
+	r.T = vrp.T;
+	r.Q = vrp.Q;
+	r.q = vrp.q;
+	r.tw.resize(n);
+	for (Vertex v: r.D.Vertices()) r.tw[v] = {vrp.T - vrp.tw[v].right, vrp.T - vrp.tw[v].left};
+	r.tau = r.arr = r.dep = r.pretau = ArcTable<PWLFunction>(r.D);
+	r.LDT = Matrix<TimeUnit>(n, n);
+	// The reverse arrival functions are the forward departure functions mirrored in the horizon. Their inverse is not
+	// the mirror of the forward arrival functions, because waiting is added at the beginning of the reverse arcs.
+	// The functions of the arcs leaving each vertex and the LDT of each vertex are independent, so they are computed
+	// concurrently.
+	PWLFunction mirror = vrp.T - PWLFunction::IdentityFunction({0.0, vrp.T});
+	parallel_for(n, [&] (int u) {
+		for (Vertex v: vrp.D.Successors(u))
+		{
+			// Compute reverse travel functions.
+			r.arr[v][u] = vrp.T - vrp.dep[u][v].Compose(mirror);
+			r.arr[v][u] = Min(PWLFunction::ConstantFunction(min(img(r.arr[v][u])), {min(r.tw[v]), min(dom(r.arr[v][u]))}), r.arr[v][u]);
+			r.tau[v][u] = r.arr[v][u] - PWLFunction::IdentityFunction({0.0, vrp.T});
+			r.dep[v][u] = r.arr[v][u].Inverse();
+			r.pretau[v][u] = PWLFunction::IdentityFunction(dom(r.dep[v][u])) - r.dep[v][u];
+		}
+	});
+	// Add travel functions for (i, i) (for boundary reasons).
+	for (Vertex u: r.D.Vertices())
+	{
+		r.tau[u][u] = r.pretau[u][u] = PWLFunction::ConstantFunction(0.0, r.tw[u]);
+		r.dep[u][u] = r.arr[u][u] = PWLFunction::IdentityFunction(r.tw[u]);
+	}
+	// Set LDT.
+	parallel_for(n, [&] (int i) {
+		vector<TimeUnit> LDT_i = compute_latest_departure_time(r.D, i, r.tw[i].right, [&] (Vertex u, Vertex v, double tf) { return r.DepartureTime({u,v}, tf); });
+		for (Vertex k: r.D.Vertices()) r.LDT[k][i] = LDT_i[k];
+	});
+	r.BuildUnreachableIndex();
+	return r;
+}
 } // namespace networks2019
\ No newline at end of file
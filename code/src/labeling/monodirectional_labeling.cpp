@@ -32,7 +32,7 @@ double beta(Label* l, bool partial)
 }
 }
 
-MonodirectionalLabeling::MonodirectionalLabeling(const VRPInstance& vrp) : vrp_(vrp)
+MonodirectionalLabeling::MonodirectionalLabeling(shared_ptr<const VRPInstance> vrp) : vrp_(vrp)
 {
 	cross = true;
 	process_limit = INT_MAX;
@@ -41,17 +41,18 @@ MonodirectionalLabeling::MonodirectionalLabeling(const VRPInstance& vrp) : vrp_(
 	relax_elementary_check = relax_cost_check = correcting = false;
 	processed_count = 0;
 	
-	t_m = vrp.T;
-	U = vector<DemandLevel>(vrp.D.VertexCount());
+	t_m = vrp->T;
+	U = vector<DemandLevel>(vrp->D.VertexCount());
+	graph_ = FilteredDigraph(vrp->D);
 	
 	// no-label is a label that represents the empty path.
 	no_label.parent = nullptr;
 	no_label.p = no_label.q = no_label.min_cost = 0.0;
-	no_label.duration = vrp.tau[vrp.o][vrp.o];
+	no_label.duration = vrp->tau[vrp->o][vrp->o];
 	no_label.rw = dom(no_label.duration);
 	no_label.length = 0;
 	no_label.S = no_label.U = {};
-	no_label.v = vrp.o;
+	no_label.v = vrp->o;
 }
 
 MonodirectionalLabeling::~MonodirectionalLabeling()
@@ -66,9 +67,8 @@ void MonodirectionalLabeling::SetProblem(const PricingProblem& pricing_problem)
 	no_label.cut_nz = {};
 	no_label.cut_visited = vector<int>(pricing_problem.S.size(), 0);
 	
-	vrp_.D.AddArcs(pp_.A); // Add previously forbidden arcs.
 	pp_ = pricing_problem;
-	vrp_.D.RemoveArcs(pp_.A); // Remove pricing problem forbidden arcs.
+	graph_.SetForbiddenArcs(pp_.A); // Mask pricing problem forbidden arcs.
 	Clean();
 }
 
@@ -168,7 +168,7 @@ vector<Label*> MonodirectionalLabeling::Run(LBQueue* q, MLBExecutionLog* log)
 
 LazyLabel MonodirectionalLabeling::Init() const
 {
-	LazyLabel ll = {(Label*) &no_label, vrp_.o, vrp_.tw[vrp_.o].left};
+	LazyLabel ll = {(Label*) &no_label, vrp_->o, vrp_->tw[vrp_->o].left};
 	if (!lazy_extension) ll.extension = ExtensionStep(ll);
 	return ll;
 }
@@ -181,32 +181,32 @@ Label* MonodirectionalLabeling::ExtensionStep(const LazyLabel& ll) const
 	Vertex u = l->v;
 	
 	// If correcting and now reaching vertex v is infeasible, return nullptr.
-	if (correcting && vrp_.ArrivalTime({u, v}, l->rw.left) == INFTY) return nullptr;
+	if (correcting && vrp_->ArrivalTime({u, v}, l->rw.left) == INFTY) return nullptr;
 	
 	// Check if depot triangle inequality holds.
 	// If max(rw(lv)) < a_v and tau_u0v(max(rw(lv))) <= a_v - max(rw(lv)) then ignore label.
-	if (epsilon_smaller(l->rw.right, vrp_.tw[v].left) && vrp_.D.IncludesArc({u, vrp_.d}) && vrp_.D.IncludesArc({vrp_.o, v}))
+	if (epsilon_smaller(l->rw.right, vrp_->tw[v].left) && graph_.IncludesArc({u, vrp_->d}) && graph_.IncludesArc({vrp_->o, v}))
 	{
-		TimeUnit tau_u0v = vrp_.TravelTime({u, vrp_.d}, max(l->rw)) + vrp_.PreTravelTime({vrp_.o, v}, vrp_.tw[v].left);
-		if (epsilon_smaller(tau_u0v, vrp_.tw[v].left - l->rw.right)) return nullptr;
+		TimeUnit tau_u0v = vrp_->TravelTime({u, vrp_->d}, max(l->rw)) + vrp_->PreTravelTime({vrp_->o, v}, vrp_->tw[v].left);
+		if (epsilon_smaller(tau_u0v, vrp_->tw[v].left - l->rw.right)) return nullptr;
 	}
 	
 	auto lv = new Label();
 	lv->parent = l;
 	lv->v = v;
-	lv->q = l->q + vrp_.q[v];
+	lv->q = l->q + vrp_->q[v];
 	lv->p = l->p + pp_.P[v];
 	lv->length = l->length + 1;
 	// If max(rw(l)) < min(img(dep_uv)) then no matter when we depart we reach v before its time window.
 	// Otherwise, we can do the classic extension D_lv(t) = D_l(\dep_uv(t)) + \tau_uv(\dep_uv(t)).
-	lv->duration = epsilon_smaller(max(l->rw), min(img(vrp_.dep[u][v])))
-		? PWLFunction::ConstantFunction(l->duration(max(l->rw)) + min(vrp_.tw[v]) - max(l->rw), {min(vrp_.tw[v]), min(vrp_.tw[v])})
-		: (l->duration + vrp_.tau[u][v]).Compose(vrp_.dep[u][v]);
+	lv->duration = epsilon_smaller(max(l->rw), min(img(vrp_->dep[u][v])))
+		? PWLFunction::ConstantFunction(l->duration(max(l->rw)) + min(vrp_->tw[v]) - max(l->rw), {min(vrp_->tw[v]), min(vrp_->tw[v])})
+		: (l->duration + vrp_->tau[u][v]).Compose(vrp_->dep[u][v]);
 	if (limited_extension && !cross) lv->duration.RestrictDomain({0.0, t_m});
 	if (lv->duration.Empty()) { delete lv; return nullptr; } // If no duration pieces exist, then the label is dominated.
 	lv->rw = dom(lv->duration);
 	lv->S = unite(l->S, {v});
-	lv->U = unite(lv->S, unreachable_strengthened ? vrp_.Unreachable(v, lv->rw.left) : vrp_.WeakUnreachable(v, lv->rw.left));
+	lv->U = unite(lv->S, unreachable_strengthened ? vrp_->Unreachable(v, lv->rw.left) : vrp_->WeakUnreachable(v, lv->rw.left));
 	// Extend cut resources.
 	lv->cut_cost = l->cut_cost;
 	lv->cut_visited = l->cut_visited;
@@ -229,7 +229,7 @@ Label* MonodirectionalLabeling::ExtensionStep(const LazyLabel& ll) const
 bool MonodirectionalLabeling::DominationStep(Label* l) const
 {
 	// If full route, then it is dominated if the reduced cost is bigger than or equal to zero.
-	if (l->v == vrp_.d) return epsilon_bigger_equal(l->min_cost, 0.0);
+	if (l->v == vrp_->d) return epsilon_bigger_equal(l->min_cost, 0.0);
 	
 	// Create function Delta which will be dominated.
 	PWLDominationFunction Delta = l->duration;
@@ -308,13 +308,16 @@ void MonodirectionalLabeling::ProcessStep(Label* l)
 vector<LazyLabel> MonodirectionalLabeling::EnumerationStep(Label* l) const
 {
 	vector<LazyLabel> E;
-	if (l->v == vrp_.d) return E; // End depot has no extensions.
-	for (Vertex v: vrp_.D.Successors(l->v))
+	if (l->v == vrp_->d) return E; // End depot has no extensions.
+	for (int k = graph_.Begin(l->v); k < graph_.End(l->v); ++k)
 	{
+		if (graph_.IsForbidden(k)) continue;
+		Vertex v = graph_.Head(k);
 		if (l->U.test(v)) continue;
-		if (epsilon_bigger(l->q + vrp_.q[v], vrp_.Q)) continue;
-		if (epsilon_bigger(min(l->rw), max(dom(vrp_.arr[l->v][v])))) continue;
-		double makespan = vrp_.arr[l->v][v](max(min(l->rw), min(dom(vrp_.arr[l->v][v]))));
+		if (epsilon_bigger(l->q + vrp_->q[v], vrp_->Q)) continue;
+		const PWLFunction& arr_e = vrp_->arr.At(k); // graph_ and arr share the CSR order of vrp_->D.
+		if (epsilon_bigger(min(l->rw), max(dom(arr_e)))) continue;
+		double makespan = arr_e(max(min(l->rw), min(dom(arr_e))));
 		LazyLabel ll{l, v, cross ? l->rw.left : makespan};
 		if (!lazy_extension)
 		{
@@ -334,6 +337,6 @@ void MonodirectionalLabeling::Clean()
 		for (auto& entry_2: entry)
 			for (Label* m: entry_2.second)
 				delete m;
-	U = vector<DemandLevel>(vrp_.D.VertexCount());
+	U = vector<DemandLevel>(vrp_->D.VertexCount());
 }
 } // networks2019
\ No newline at end of file
@@ -9,11 +9,14 @@
 #include <goc/goc.h>
 
 #include "vrp_instance.h"
+#include "vrp_instance_builder.h"
+#include "instance_reader.h"
+#include "vrp_snapshot.h"
 #include "preprocess/preprocess_travel_times.h"
 #include "preprocess/preprocess_capacity.h"
 #include "preprocess/preprocess_time_windows.h"
 #include "preprocess/preprocess_service_waiting.h"
-#include "preprocess/preprocess_triangle_depot.h"
+#include "preprocess/preprocess_breakpoints.h"
 
 #include "labeling/bidirectional_labeling.h"
 
@@ -37,11 +40,22 @@ int main(int argc, char** argv)
 	{
 		json output; // STDOUT output will go into this JSON.
 
-		if (argc > 1)
-			simulate_runner_input("instances/networks_2019b", "RC204_25_a", "experiments/pricing.json", "Basic");
+		// Arguments: --snapshot <path> loads the preprocessed instance from the snapshot (it is created if it does not
+		// exist), any other argument simulates the runner input.
+		string snapshot_path;
+		bool simulate = false;
+		for (int i = 1; i < argc; ++i)
+		{
+			if (string(argv[i]) == "--snapshot" && i+1 < argc) snapshot_path = argv[++i];
+			else simulate = true;
+		}
+		if (simulate) simulate_runner_input("instances/networks_2019b", "RC204_25_a", "experiments/pricing.json", "Basic");
 
+		// The instance is streamed into its typed attributes, instance only keeps the remaining ones.
 		json experiment, instance, solutions;
-		cin >> experiment >> instance >> solutions;
+		cin >> experiment;
+		VRPInstanceBuilder builder = read_vrp_instance(cin, &instance);
+		cin >> solutions;
 
 		// Parse experiment.
 		Duration time_limit = value_or_default(experiment, "time_limit", 2.0_hr);
@@ -52,6 +66,7 @@ int main(int argc, char** argv)
 		bool unreachable_strengthened = value_or_default(experiment, "unreachable_strengthened", true);
 		bool sort_by_cost = value_or_default(experiment, "sort_by_cost", true);
 		bool symmetric = value_or_default(experiment, "symmetric", false);
+		double breakpoint_tolerance = value_or_default(experiment, "breakpoint_tolerance", 0.0);
 
 		// Show experiment details.
 		clog << "Time limit: " << time_limit << "s." << endl;
@@ -62,24 +77,48 @@ int main(int argc, char** argv)
 		clog << "Unreachable strengthened: " << unreachable_strengthened << endl;
 		clog << "Sort by cost: " << sort_by_cost << endl;
 		clog << "Symmetric: " << symmetric << endl;
-
-		// Preprocess instance JSON.
-		clog << "Preprocessing..." << endl;
-		preprocess_capacity(instance);
-		preprocess_travel_times(instance);
-		preprocess_service_waiting(instance);
-		preprocess_time_windows(instance);
-		preprocess_triangle_depot(instance);
-
-		// Parse instance.
-		VRPInstance vrp = instance;
+		clog << "Breakpoint tolerance: " << breakpoint_tolerance << endl;
+
+		// Parse instance and preprocess it, or load it (and its reverse) from the snapshot.
+		VRPInstance vrp_instance, reverse_vrp_instance;
+		string instance_name = value_or_default(instance, "instance_name", "");
+		if (!snapshot_path.empty() && instance_name.empty()) fail("The snapshot needs the instance_name of the instance.");
+		BreakpointReduction reduction;
+		if (!snapshot_path.empty() && snapshot_exists(snapshot_path))
+		{
+			clog << "Loading snapshot..." << endl;
+			load_snapshot(snapshot_path, instance_name, breakpoint_tolerance, &reduction, &vrp_instance,
+				&reverse_vrp_instance);
+		}
+		else
+		{
+			clog << "Preprocessing..." << endl;
+			preprocess_capacity(builder);
+			preprocess_travel_times(builder);
+			preprocess_service_waiting(builder);
+			if (breakpoint_tolerance > 0.0) reduction = preprocess_breakpoints(builder, breakpoint_tolerance);
+			preprocess_time_windows(builder);
+			vrp_instance = builder.Build();
+			reverse_vrp_instance = reverse_instance(vrp_instance);
+			if (!snapshot_path.empty())
+				save_snapshot(snapshot_path, instance_name, breakpoint_tolerance, reduction, vrp_instance,
+					reverse_vrp_instance);
+		}
+		if (breakpoint_tolerance > 0.0)
+		{
+			clog << "Breakpoint reduction: " << reduction.piece_count_before << " -> " << reduction.piece_count_after
+				<< " pieces." << endl;
+			output["Breakpoint reduction"] = reduction;
+		}
+		auto vrp = make_shared<const VRPInstance>(move(vrp_instance));
+		auto reverse_vrp = make_shared<const VRPInstance>(move(reverse_vrp_instance));
 
 		// Read pricing problem.
 		PricingProblem pp;
 		pp.P = vector<ProfitUnit>(instance["profits"].begin(), instance["profits"].end());
 
 		clog << "Running pricing algorithm..." << endl;
-		BidirectionalLabeling lbl(vrp);
+		BidirectionalLabeling lbl(vrp, reverse_vrp);
 		lbl.screen_output = &clog;
 		lbl.time_limit = time_limit;
 		lbl.correcting = correcting;
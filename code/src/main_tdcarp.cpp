@@ -11,11 +11,14 @@
 #include <goc/goc.h>
 
 #include "vrp_instance.h"
+#include "vrp_instance_builder.h"
+#include "instance_reader.h"
+#include "vrp_snapshot.h"
 #include "preprocess/preprocess_travel_times.h"
 #include "preprocess/preprocess_capacity.h"
 #include "preprocess/preprocess_time_windows.h"
 #include "preprocess/preprocess_service_waiting.h"
-#include "preprocess/preprocess_triangle_depot.h"
+#include "preprocess/preprocess_breakpoints.h"
 #include "tdcarp/transform_problem.h"
 
 #include "bcp/bcp.h"
@@ -42,15 +45,41 @@ int main(int argc, char** argv)
 	{
 		json output; // STDOUT output will go into this JSON.
 
-		if (argc > 1) simulate_runner_input("instances/vidal_et_al_2020", "M_C01", "experiments/tdcarp.json", "TDCARP-BASE");
+		// Arguments: --snapshot <path> loads the preprocessed instance from the snapshot (it is created if it does not
+		// exist), any other argument simulates the runner input.
+		string snapshot_path;
+		bool simulate = false;
+		for (int i = 1; i < argc; ++i)
+		{
+			if (string(argv[i]) == "--snapshot" && i+1 < argc) snapshot_path = argv[++i];
+			else simulate = true;
+		}
+		if (simulate) simulate_runner_input("instances/vidal_et_al_2020", "M_C01", "experiments/tdcarp.json", "TDCARP-BASE");
 
+		// The instance is streamed into its typed attributes, instance only keeps the remaining ones.
 		json experiment, instance, solutions;
-		cin >> experiment >> instance >> solutions;
+		cin >> experiment;
+		TDCARPInstance tdcarp_instance = read_tdcarp_instance(cin, &instance);
+		cin >> solutions;
 
 		// Parse experiment.
 		Duration time_limit = value_or_default(experiment, "time_limit", 2.0_hr);
 		int cut_limit = value_or_default(experiment, "cut_limit", 100);
+		int cuts_per_round = value_or_default(experiment, "cuts_per_round", 1);
+		int separation_threads = value_or_default(experiment, "separation_threads", 1);
 		int node_limit = value_or_default(experiment, "node_limit", INT_MAX);
+		int strong_branch_size = value_or_default(experiment, "strong_branch_size", 10);
+		int strong_branch_threads = value_or_default(experiment, "strong_branch_threads", 1);
+		int tree_threads = value_or_default(experiment, "tree_threads", 1);
+		int column_age_limit = value_or_default(experiment, "column_age_limit", INT_MAX);
+		CGStabilization dual_stabilization = value_or_default(experiment, "dual_stabilization", "None");
+		double smoothing_factor = value_or_default(experiment, "smoothing_factor", 0.8);
+		double cg_gap_tolerance = value_or_default(experiment, "cg_gap_tolerance", 0.0);
+		int thread_budget = value_or_default(experiment, "thread_budget", ThreadBudget::Process().Capacity());
+		ThreadBudget::Process().SetCapacity(thread_budget); // shared by the preprocessing, the BCP threads and CPLEX.
+		json lp_config = value_or_default(experiment, "lp_config", json::object());
+		json root_lp_config = value_or_default(experiment, "root_lp_config", json::object());
+		json mip_config = value_or_default(experiment, "mip_config", json::object());
 		bool partial = value_or_default(experiment, "partial", true);
 		bool limited_extension = value_or_default(experiment, "limited_extension", true);
 		bool lazy_extension = value_or_default(experiment, "lazy_extension", true);
@@ -59,12 +88,26 @@ int main(int argc, char** argv)
 		bool symmetric = value_or_default(experiment, "symmetric", false);
 		bool iterative_merge = value_or_default(experiment, "iterative_merge", true);
 		bool exact_labeling = value_or_default(experiment, "exact_labeling", true);
+		double breakpoint_tolerance = value_or_default(experiment, "breakpoint_tolerance", 0.0);
 
 
 		// Show experiment details.
 		clog << "Time limit: " << time_limit << "s." << endl;
 		clog << "Cut limit: " << cut_limit << endl;
+		clog << "Cuts per round: " << cuts_per_round << endl;
+		clog << "Separation threads: " << separation_threads << endl;
 		clog << "Node limit: " << node_limit << endl;
+		clog << "Strong branch size: " << strong_branch_size << endl;
+		clog << "Strong branch threads: " << strong_branch_threads << endl;
+		clog << "Tree threads: " << tree_threads << endl;
+		clog << "Column age limit: " << column_age_limit << endl;
+		clog << "Dual stabilization: " << dual_stabilization << endl;
+		clog << "Smoothing factor: " << smoothing_factor << endl;
+		clog << "CG gap tolerance: " << cg_gap_tolerance << endl;
+		clog << "Thread budget: " << thread_budget << endl;
+		clog << "LP config: " << lp_config << endl;
+		clog << "Root LP config: " << root_lp_config << endl;
+		clog << "MIP config: " << mip_config << endl;
 		clog << "Partial: " << partial << endl;
 		clog << "Limited extension: " << limited_extension << endl;
 		clog << "Lazy extension: " << lazy_extension << endl;
@@ -73,59 +116,104 @@ int main(int argc, char** argv)
 		clog << "Symmetric: " << symmetric << endl;
 		clog << "Iterative merge: " << iterative_merge << endl;
 		clog << "Exact labeling: " << exact_labeling << endl;
+		clog << "Breakpoint tolerance: " << breakpoint_tolerance << endl;
 
-		// Transform problem to TDVRPTW
-		instance = transform_problem(instance);
-
-		// Preprocess instance JSON.
-		clog << "Preprocessing..." << endl;
-		preprocess_capacity(instance);        // removes edges whose demands are higher than the capacity
-		preprocess_service_waiting(instance); // puts time window and service time info into travel time (and updates all accordingly)
-											  // [one thing it does is restrict the travel time to the origin's tw (which I think should be done later)]
-											  // obs: no service logic should be ran for tdcarp, but it is done to run the restrictions to travel time]
-		preprocess_time_windows(instance);    // trims tws according to earliest_departure/latest_arrival of succesors/predecesor
-											  // (and removes edges with resulting empty tws)
-		preprocess_triangle_depot(instance);  // removes edges i->j if it's better to go i->depot->j
-
-		// Parse instance.
-		VRPInstance vrp = instance;
+		// Parse instance and preprocess it, or load it (and its reverse) from the snapshot.
+		VRPInstance vrp_instance, reverse_vrp_instance;
+		string instance_name = value_or_default(instance, "instance_name", "");
+		if (!snapshot_path.empty() && instance_name.empty()) fail("The snapshot needs the instance_name of the instance.");
+		BreakpointReduction reduction;
+		if (!snapshot_path.empty() && snapshot_exists(snapshot_path))
+		{
+			clog << "Loading snapshot..." << endl;
+			load_snapshot(snapshot_path, instance_name, breakpoint_tolerance, &reduction, &vrp_instance,
+				&reverse_vrp_instance);
+		}
+		else
+		{
+			clog << "Preprocessing..." << endl;
+			// Transform problem to TDVRPTW
+			TransformationLog transformation_log;
+			VRPInstanceBuilder builder = transform_problem(tdcarp_instance, &transformation_log);
+			clog << "Transformation time: " << transformation_log.time << endl;
+			output["Transformation"] = transformation_log;
+			preprocess_capacity(builder);         // removes edges whose demands are higher than the capacity
+			preprocess_service_waiting(builder);  // puts time window and service time info into travel time (and updates all accordingly)
+												  // [one thing it does is restrict the travel time to the origin's tw (which I think should be done later)]
+												  // obs: no service logic should be ran for tdcarp, but it is done to run the restrictions to travel time]
+			if (breakpoint_tolerance > 0.0) reduction = preprocess_breakpoints(builder, breakpoint_tolerance);
+			preprocess_time_windows(builder);     // trims tws according to earliest_departure/latest_arrival of succesors/predecesor
+												  // (and removes edges with resulting empty tws, and edges i->j if it's better to go i->depot->j)
+			vrp_instance = builder.Build();
+			reverse_vrp_instance = reverse_instance(vrp_instance);
+			if (!snapshot_path.empty())
+				save_snapshot(snapshot_path, instance_name, breakpoint_tolerance, reduction, vrp_instance,
+					reverse_vrp_instance);
+		}
+		if (breakpoint_tolerance > 0.0)
+		{
+			clog << "Breakpoint reduction: " << reduction.piece_count_before << " -> " << reduction.piece_count_after
+				<< " pieces." << endl;
+			output["Breakpoint reduction"] = reduction;
+		}
+		auto vrp = make_shared<const VRPInstance>(move(vrp_instance));
+		auto reverse_vrp = make_shared<const VRPInstance>(move(reverse_vrp_instance));
 
 		// Run BCP.
 		clog << "Running BCP algorithm for TDCARP..." << endl;
 
 		// Create SPF and add initial routes (o, i, d).
-		SPF spf(vrp.D.VertexCount());
-		for (Vertex i: exclude(vrp.D.Vertices(), {vrp.o, vrp.d}))
-			spf.AddRoute(vrp.BestDurationRoute({vrp.o, i, vrp.d}));
+		SPF spf(vrp->D.VertexCount());
+		for (Vertex i: exclude(vrp->D.Vertices(), {vrp->o, vrp->d}))
+			spf.AddRoute(vrp->BestDurationRoute({vrp->o, i, vrp->d}));
 
-		BCP bcp(vrp.D, &spf);
+		BCP bcp(vrp, &spf);
 		bcp.time_limit = time_limit;
 		bcp.cut_limit = cut_limit;
+		bcp.cuts_per_round = cuts_per_round;
+		bcp.separation_threads = separation_threads;
+		bcp.strong_branch_size = strong_branch_size;
+		bcp.strong_branch_threads = strong_branch_threads;
+		bcp.tree_threads = tree_threads;
+		bcp.column_age_limit = column_age_limit;
+		bcp.dual_stabilization = dual_stabilization;
+		bcp.smoothing_factor = smoothing_factor;
+		bcp.cg_gap_tolerance = cg_gap_tolerance;
+		bcp.lp_config = lp_config;
+		bcp.root_lp_config = root_lp_config;
+		bcp.mip_config = mip_config;
 		bcp.node_limit = node_limit;
 
-		BidirectionalLabeling lbl(vrp);
-		lbl.solution_limit = 3000;
-		lbl.closing_state = !iterative_merge;
-		lbl.partial = partial;
-		lbl.limited_extension = limited_extension;
-		lbl.lazy_extension = lazy_extension;
-		lbl.unreachable_strengthened = unreachable_strengthened;
-		lbl.sort_by_cost = sort_by_cost;
-		lbl.symmetric = symmetric;
-
-		int heuristic_level = 0; // 0: relax cost, 1: relax elementarity, 2: exact
+		// Create one labeling per tree worker, all of them share the instance and its reverse.
+		vector<unique_ptr<BidirectionalLabeling>> labelings(tree_threads);
+		for (auto& lbl: labelings)
+		{
+			lbl.reset(new BidirectionalLabeling(vrp, reverse_vrp));
+			lbl->solution_limit = 3000;
+			lbl->closing_state = !iterative_merge;
+			lbl->partial = partial;
+			lbl->limited_extension = limited_extension;
+			lbl->lazy_extension = lazy_extension;
+			lbl->unreachable_strengthened = unreachable_strengthened;
+			lbl->sort_by_cost = sort_by_cost;
+			lbl->symmetric = symmetric;
+		}
+
+		vector<int> heuristic_levels(tree_threads, 0); // heuristic level of each worker.
 		int max_level = exact_labeling ? 2 : 1; // exact
 		vector<string> level_name = {"Heuristic Cost", "Heuristic Elementarity", "Exact"};
-		bcp.pricing_solver = [&](const PricingProblem &pricing_problem, int node_number, Duration tlimit,
-								 CGExecutionLog *cg_execution_log) {
+		bcp.pricing_solver = [&](const PricingProblem &pricing_problem, int node_number, int worker, Duration tlimit,
+								 CGExecutionLog *cg_execution_log, vector<Route>* R) {
 			Stopwatch iteration_rolex(true);
-			vector<Route> R;
+			BidirectionalLabeling& lbl = *labelings[worker];
+			int& heuristic_level = heuristic_levels[worker]; // 0: relax cost, 1: relax elementarity, 2: exact
+			double min_reduced_cost = -INFTY; // only proven when the exact labeling finishes.
 			while (heuristic_level <= max_level)
 			{
 				lbl.time_limit = tlimit - iteration_rolex.Peek();
 				lbl.relax_cost_check = heuristic_level == 0;
 				lbl.relax_elementary_check = heuristic_level == 1;
-				auto lbl_log = lbl.Run(pricing_problem, &R);
+				auto lbl_log = lbl.Run(pricing_problem, R);
 
 				// Add iteration log.
 				cg_execution_log->iterations->push_back(lbl_log);
@@ -135,17 +223,24 @@ int main(int argc, char** argv)
 				lbl.closing_state |= heuristic_level == 2 && lbl_log.status == BLBStatus::Finished;
 				lbl.merge_start = (lbl.merge_start + lbl_log.forward_log->processed_count) / 2;
 
-				if (!R.empty()) break;
+				// The exact labeling finds the minimum reduced cost route unless it stopped early.
+				if (heuristic_level == 2 && lbl_log.status == BLBStatus::Finished)
+				{
+					min_reduced_cost = 0.0;
+					for (auto& r: *R) min_reduced_cost = min(min_reduced_cost, pricing_problem.ReducedCost(r));
+				}
+
+				if (!R->empty()) break;
 				++heuristic_level;
 			}
-			// Add negative reduced cost routes.
-			for (auto &r: R) spf.AddRoute(r);
+			// Negative reduced cost routes in R are added to the SPF by the BCP.
 			if (heuristic_level > max_level)
 			{
 				heuristic_level = 0;
 				lbl.closing_state = false;
 				lbl.merge_start = 0;
 			}
+			return min_reduced_cost;
 		};
 		VRPSolution solution(INFTY, {});
 		auto log = bcp.Run(&solution);
@@ -0,0 +1,43 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "preprocess/preprocess_breakpoints.h"
+
+using namespace std;
+using namespace goc;
+using namespace nlohmann;
+
+namespace networks2019
+{
+BreakpointReduction preprocess_breakpoints(VRPInstanceBuilder& instance, double tolerance)
+{
+	Digraph& D = instance.D;
+	Matrix<PWLFunction>& tau = instance.tau;
+	BreakpointReduction reduction;
+	for (Vertex i: D.Vertices())
+	{
+		for (Vertex j: D.Successors(i))
+		{
+			reduction.piece_count_before += tau[i][j].PieceCount();
+			if (!tau[i][j].Empty())
+			{
+				// The arrival time function is non decreasing, and so is its simplification (FIFO property).
+				PWLFunction arr = tau[i][j] + PWLFunction::IdentityFunction(tau[i][j].Domain());
+				arr = arr.Simplify(tolerance);
+				tau[i][j] = arr - PWLFunction::IdentityFunction(arr.Domain());
+			}
+			reduction.piece_count_after += tau[i][j].PieceCount();
+		}
+	}
+	return reduction;
+}
+
+void to_json(json& j, const BreakpointReduction& reduction)
+{
+	j["piece_count_before"] = reduction.piece_count_before;
+	j["piece_count_after"] = reduction.piece_count_after;
+}
+} // namespace networks2019
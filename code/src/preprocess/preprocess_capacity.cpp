@@ -12,27 +12,14 @@ using namespace nlohmann;
 
 namespace networks2019
 {
-namespace
+void preprocess_capacity(VRPInstanceBuilder& instance)
 {
-// Removes the arc ij from the instance.
-void remove_arc(Vertex i, Vertex j, json& instance)
-{
-	if (instance["digraph"]["arcs"][i][j] == 0) return;
-	instance["digraph"]["arcs"][i][j] = 0;
-	int arc_count = instance["digraph"]["arc_count"];
-	instance["digraph"]["arc_count"] = arc_count - 1;
-	if (has_key(instance, "travel_times")) instance["travel_times"][i][j] = vector<json>({});
-}
-}
-
-void preprocess_capacity(json& instance)
-{
-	double Q = instance["capacity"];
-	vector<double> q = instance["demands"];
-	Digraph D = instance["digraph"];
-	for (Vertex i: D.Vertices())
-		for (Vertex j: D.Successors(i))
-			if (epsilon_bigger(q[i]+q[j], Q))
-				remove_arc(i, j, instance);
+	double Q = instance.Q;
+	auto& q = instance.q;
+	vector<Arc> removed;
+	for (Arc e: instance.D.Arcs())
+		if (epsilon_bigger(q[e.tail]+q[e.head], Q))
+			removed.push_back(e);
+	instance.RemoveArcs(removed);
 }
 } // namespace networks2019
\ No newline at end of file
@@ -12,13 +12,13 @@ using namespace nlohmann;
 
 namespace networks2019
 {
-void preprocess_service_waiting(json& instance)
+void preprocess_service_waiting(VRPInstanceBuilder& instance)
 {
-	Digraph D = instance["digraph"];
-	Matrix<PWLFunction> tau = instance["travel_times"];
-	auto s = [&] (Vertex i) -> double { return instance["service_times"][i]; };
-	auto a = [&] (Vertex i) -> double { return instance["time_windows"][i][0]; };
-	auto b = [&] (Vertex i) -> double { return instance["time_windows"][i][1]; };
+	Digraph& D = instance.D;
+	Matrix<PWLFunction>& tau = instance.tau;
+	auto s = [&] (Vertex i) -> double { return instance.s[i]; };
+	auto a = [&] (Vertex i) -> double { return instance.tw[i].left; };
+	auto b = [&] (Vertex i) -> double { return instance.tw[i].right; };
 	
 	/// (iii) \tau'_ij(t) = max(a_j, t+\tau_ij(t)) - t + s_j for each ij \in A.
 	for (Vertex i: D.Vertices())
@@ -34,19 +34,11 @@ void preprocess_service_waiting(json& instance)
 			tau[i][j] = arr - id;
 		}
 	}
-	instance["travel_times"] = tau;
 	
 	// (ii) a'_i = a_i + s_i, b'_i = b_i + s_i for each i \in V.
-	if (has_key(instance, "time_windows"))
-	{
-		for (Vertex i: D.Vertices()) instance["time_windows"][i][0] = a(i) + s(i);
-		for (Vertex i: D.Vertices()) instance["time_windows"][i][1] = b(i) + s(i);
-	}
+	for (Vertex i: D.Vertices()) instance.tw[i] = {a(i) + s(i), b(i) + s(i)};
 	
 	// (i) 	s'i = 0.
-	if (has_key(instance, "service_times"))
-	{
-		for (Vertex i: D.Vertices()) instance["service_times"][i] = 0.0;
-	}
+	for (Vertex i: D.Vertices()) instance.s[i] = 0.0;
 }
 } // namespace networks2019
\ No newline at end of file
@@ -6,8 +6,10 @@
 
 #include "preprocess/preprocess_time_windows.h"
 
+#include <deque>
 #include <vector>
-#include <queue>
+
+#include "preprocess/preprocess_triangle_depot.h"
 
 using namespace std;
 using namespace goc;
@@ -19,10 +21,9 @@ namespace
 {
 // Calculates the time to depart to traverse arc e arriving at tf.
 // Returns: INFTY if it is infeasible to depart inside the horizon.
-double departing_time(const json& instance, Arc e, double tf)
+double departing_time(const Matrix<PWLFunction>& arr, Arc e, double tf)
 {
-	PWLFunction tau_e = instance["travel_times"][e.tail][e.head];
-	PWLFunction arr_e = tau_e + PWLFunction::IdentityFunction(dom(tau_e));
+	const PWLFunction& arr_e = arr[e.tail][e.head];
 	if (epsilon_smaller(tf, min(img(arr_e)))) return INFTY;
 	else if (epsilon_bigger(tf, max(img(arr_e)))) return max(dom(arr_e));
 	return arr_e.PreValue(tf);
@@ -30,98 +31,95 @@ double departing_time(const json& instance, Arc e, double tf)
 
 // Calculates the travel time to traverse arc e departing at t0.
 // Returns: INFTY if it is infeasible to arrive inside the horizon.
-double travel_time(const json& instance, Arc e, double t0)
+double travel_time(const VRPInstanceBuilder& instance, Arc e, double t0)
 {
-	PWLFunction tau_e = instance["travel_times"][e.tail][e.head];
+	const PWLFunction& tau_e = instance.tau[e.tail][e.head];
 	if (!tau_e.Domain().Includes(t0)) return INFTY;
 	return tau_e(t0);
 }
 
 // Returns: the latest we can arrive to k if departing from i (and traversing arc (i, k)) without waiting.
-double latest_arrival(json& instance, Vertex i, Vertex k)
+double latest_arrival(const VRPInstanceBuilder& instance, const Matrix<PWLFunction>& arr, Vertex i, Vertex k)
 {
-	vector<Interval> tw = instance["time_windows"];
-	if (departing_time(instance, {i, k}, tw[k].right) != INFTY) return tw[k].right;
+	auto& tw = instance.tw;
+	if (departing_time(arr, {i, k}, tw[k].right) != INFTY) return tw[k].right;
 	return tw[i].right + travel_time(instance, {i, k}, tw[i].right);
 }
 
 // Returns: the earliest we can depart from i, to reach k inside its time window without waiting.
-double earliest_departure(json& instance, Vertex i, Vertex k)
-{
-	vector<Interval> tw = instance["time_windows"];
-	if (departing_time(instance, {i, k}, tw[k].left) != INFTY)
-		return departing_time(instance, {i, k}, tw[k].left) != INFTY;
-	return tw[i].left;
-}
-
-// Earliest arrival time from i to all vertices if departing at a_i.
-vector<double> compute_EAT(json& instance, Vertex i)
-{
-	return compute_earliest_arrival_time(instance["digraph"], i, instance["time_windows"][i][0], [&] (Vertex u, Vertex v, double t0) {
-		return travel_time(instance, {u, v}, t0);
-	});
-}
-
-// Latest departure time from all vertices to j if arriving to j at tf.
-vector<double> compute_LDT(json& instance, Vertex j)
-{
-	return compute_latest_departure_time(instance["digraph"], j, instance["time_windows"][j][1], [&] (Vertex u, Vertex v, double t0) {
-		return departing_time(instance, {u, v}, t0);
-	});
-}
-
-// Removes the arc ij from the instance.
-void remove_arc(json& instance, Vertex i, Vertex j)
-{
-	if (instance["digraph"]["arcs"][i][j] == 0) return;
-	instance["digraph"]["arcs"][i][j] = 0;
-	int arc_count = instance["digraph"]["arc_count"];
-	instance["digraph"]["arc_count"] = arc_count - 1;
-	if (has_key(instance, "travel_times")) instance["travel_times"][i][j] = vector<json>({});
-}
-
-// Returns: if the instance includes the arc.
-bool includes_arc(json& instance, Arc ij)
+double earliest_departure(const VRPInstanceBuilder& instance, const Matrix<PWLFunction>& arr, Vertex i, Vertex k)
 {
-	return instance["digraph"]["arcs"][ij.tail][ij.head] == 1;
+	auto& tw = instance.tw;
+	double t = departing_time(arr, {i, k}, tw[k].left);
+	return t != INFTY ? t : tw[i].left;
 }
 }
 
-void preprocess_time_windows(json& instance)
+void preprocess_time_windows(VRPInstanceBuilder& instance)
 {
-	Digraph D = instance["digraph"];
-	int n = D.VertexCount();
-	auto& V = D.Vertices();
-	auto a = [&] (Vertex i) -> double { return instance["time_windows"][i][0]; };
-	auto b = [&] (Vertex i) -> double { return instance["time_windows"][i][1]; };
-	Vertex o = instance["start_depot"];
-	Vertex d = instance["end_depot"];
-	auto set_a = [&] (Vertex i, double t) { instance["time_windows"][i][0] = t; };
-	auto set_b = [&] (Vertex i, double t) { instance["time_windows"][i][1] = t; };
-	
-	// Rule 1: (3.12) 	Upper bound adjustment derived from the latest arrival time at node k from its predecessors,
-	//					for k \in N - {o, d}.
-	for (Vertex k:exclude(V, {o,d}))
-	{
-		double max_arrival = -INFTY;
-		for (Vertex i: D.Predecessors(k)) max_arrival = max(max_arrival, latest_arrival(instance, i, k));
-		set_b(k, min(b(k), max(a(k), max_arrival)));
-	}
+	Digraph& D = instance.D;
+	auto a = [&] (Vertex i) -> double { return instance.tw[i].left; };
+	auto b = [&] (Vertex i) -> double { return instance.tw[i].right; };
+	Vertex o = instance.o;
+	Vertex d = instance.d;
 	
-	// Rule 2: (3.13)	Lower bound adjustment derived from the earliest departure time from node k to its successors,
-	//					for k \in N - {o,d}.
-	for (Vertex k:exclude(V, {o,d}))
+	// The travel times do not change when arcs are removed, so the arrival functions are built once.
+	Matrix<PWLFunction> arr(D.VertexCount(), D.VertexCount());
+	for (Arc e: D.Arcs())
 	{
-		double min_dep = INFTY;
-		for (Vertex j: D.Successors(k)) min_dep = min(min_dep, earliest_departure(instance, k, j));
-		set_a(k, max(a(k), min(b(k), min_dep)));
+		const PWLFunction& tau_e = instance.tau[e.tail][e.head];
+		arr[e.tail][e.head] = tau_e + PWLFunction::IdentityFunction(dom(tau_e));
 	}
 	
-	// Remove infeasible tw arcs.
-	for (Arc ij: D.Arcs())
+	// Each tightening may enable others, so the rules are applied until a fixed point is reached. The worklist has the
+	// vertices whose rules or outgoing arcs may have changed: the neighbors of the vertices whose time window changed,
+	// and the endpoints of the removed arcs.
+	deque<Vertex> worklist(D.Vertices().begin(), D.Vertices().end());
+	vector<bool> queued(D.VertexCount(), true);
+	auto enqueue = [&] (Vertex v) { if (!queued[v]) worklist.push_back(v), queued[v] = true; };
+	while (!worklist.empty())
 	{
-		int i = ij.tail, j = ij.head;
-		if (epsilon_bigger(a(i)+travel_time(instance, {i, j}, a(i)), b(j))) remove_arc(instance, i, j);
+		Vertex k = worklist.front();
+		worklist.pop_front();
+		queued[k] = false;
+		
+		if (k != o && k != d)
+		{
+			// Rule 1: (3.12) 	Upper bound adjustment derived from the latest arrival time at node k from its
+			//					predecessors.
+			double max_arrival = -INFTY;
+			for (Vertex i: D.Predecessors(k)) max_arrival = max(max_arrival, latest_arrival(instance, arr, i, k));
+			double b_k = min(b(k), max(a(k), max_arrival));
+			if (epsilon_smaller(b_k, b(k)))
+			{
+				instance.tw[k].right = b_k;
+				for (Vertex j: D.Successors(k)) enqueue(j);
+				for (Vertex i: D.Predecessors(k)) enqueue(i);
+			}
+			
+			// Rule 2: (3.13)	Lower bound adjustment derived from the earliest departure time from node k to its
+			//					successors.
+			double min_dep = INFTY;
+			for (Vertex j: D.Successors(k)) min_dep = min(min_dep, earliest_departure(instance, arr, k, j));
+			double a_k = max(a(k), min(b(k), min_dep));
+			if (epsilon_bigger(a_k, a(k)))
+			{
+				instance.tw[k].left = a_k;
+				for (Vertex i: D.Predecessors(k)) enqueue(i);
+			}
+		}
+		
+		// Remove the arcs leaving k that are infeasible by the time windows, or worse than going through the depot.
+		vector<Arc> removed;
+		for (Vertex j: D.Successors(k))
+			if (epsilon_bigger(a(k)+travel_time(instance, {k, j}, a(k)), b(j)) || is_dominated_by_depot(instance, {k, j}))
+				removed.push_back({k, j});
+		for (Arc ij: removed)
+		{
+			instance.RemoveArc(ij);
+			enqueue(ij.tail);
+			enqueue(ij.head);
+		}
 	}
 }
 } // namespace networks2019
\ No newline at end of file
@@ -6,6 +6,9 @@
 
 #include "preprocess/preprocess_travel_times.h"
 
+#include <map>
+#include <queue>
+
 using namespace std;
 using namespace goc;
 using namespace nlohmann;
@@ -16,12 +19,12 @@ namespace
 {
 // Calculates the time to depart to traverse arc e arriving at tf.
 // Returns: INFTY if it is infeasible to depart inside the horizon.
-double departing_time(const json& instance, Arc e, double tf)
+double departing_time(const VRPInstanceBuilder& instance, Arc e, double tf)
 {
-	int c = instance["clusters"][e.tail][e.head]; // cluster of arc e.
-	vector<Interval> T = instance["speed_zones"]; // T[k] = speed zone k.
-	vector<double> speed = instance["cluster_speeds"][c]; // speed[k] = speed of traversing e in speed zone k.
-	double d = instance["distances"][e.tail][e.head]; // distance of arc e.
+	int c = instance.clusters[e.tail][e.head]; // cluster of arc e.
+	auto& T = instance.speed_zones; // T[k] = speed zone k.
+	auto& speed = instance.cluster_speeds[c]; // speed[k] = speed of traversing e in speed zone k.
+	double d = instance.distances[e.tail][e.head]; // distance of arc e.
 	double t = tf;
 	for (int k = (int)T.size()-1; k >= 0; --k)
 	{
@@ -40,12 +43,12 @@ double departing_time(const json& instance, Arc e, double tf)
 
 // Calculates the travel time to traverse arc e departing at t0.
 // Returns: INFTY if it is infeasible to arrive inside the horizon.
-double travel_time(const json& instance, Arc e, double t0)
+double travel_time(const VRPInstanceBuilder& instance, Arc e, double t0)
 {
-	int c = instance["clusters"][e.tail][e.head]; // cluster of arc e.
-	vector<Interval> T = instance["speed_zones"]; // T[k] = speed zone k.
-	vector<double> speed = instance["cluster_speeds"][c]; // speed[k] = speed of traversing e in speed zone k.
-	double d = instance["distances"][e.tail][e.head]; // distance of arc e.
+	int c = instance.clusters[e.tail][e.head]; // cluster of arc e.
+	auto& T = instance.speed_zones; // T[k] = speed zone k.
+	auto& speed = instance.cluster_speeds[c]; // speed[k] = speed of traversing e in speed zone k.
+	double d = instance.distances[e.tail][e.head]; // distance of arc e.
 	double t = t0;
 	for (int k = 0; k < T.size(); ++k)
 	{
@@ -62,17 +65,17 @@ double travel_time(const json& instance, Arc e, double t0)
 }
 
 // Returns the time when we arrive at the end of arc e if departing at t0.
-double ready_time(const json& instance, Arc e, double t0)
+double ready_time(const VRPInstanceBuilder& instance, Arc e, double t0)
 {
 	double tt = travel_time(instance, e, t0);
 	return tt == INFTY ? tt : t0 + tt;
 }
 
 // Precondition: no speeds are 0.
-PWLFunction compute_travel_time_function(const json& instance, Arc e)
+PWLFunction compute_travel_time_function(const VRPInstanceBuilder& instance, Arc e)
 {
 	// Calculate speed breakpoints.
-	vector<Interval> speed_zones = instance["speed_zones"];
+	auto& speed_zones = instance.speed_zones;
 	vector<double> speed_breakpoints;
 	for (auto& z: speed_zones) speed_breakpoints.push_back(z.left);
 	speed_breakpoints.push_back(speed_zones.back().right);
@@ -110,50 +113,72 @@ PWLFunction compute_travel_time_function(const json& instance, Arc e)
 }
 }
 
-Matrix<PWLFunction> quickest_paths(Digraph D, Matrix<PWLFunction> arriving_times, Interval horizon)
+Matrix<PWLFunction> quickest_paths(const Digraph& D, const ArcTable<PWLFunction>& arriving_times, Interval horizon,
+	const vector<Vertex>& sources)
 {
-	// Quickest paths algorithm
-	Matrix<PWLFunction> xxxx(D.VertexCount(), D.VertexCount());
-	for (Vertex v : D.Vertices()) {
-		auto& xx = xxxx[v];
-		for (Vertex w : D.Vertices()) {
-			if (w == v) {
-				xx[w] = PWLFunction::IdentityFunction(horizon);
-			} else {
-				// Empty PWLFunction
-			}
-		}
-
-		for (int i = 0; i <= D.VertexCount(); i++) { // Could be done better
-			for (Vertex from : D.Vertices()) {
-				for (Arc e : D.OutboundArcs(from)) {
-					auto yy = arriving_times[e.tail][e.head].Compose(xx[e.tail]);
-					xx[e.head] = Min(xx[e.head], yy);
-				}
+	int n = D.VertexCount(), m = sources.size();
+	Matrix<PWLFunction> quickest(m, n);
+	
+	// Profile search from each source v: arrival[w](t) = earliest arrival at w departing from v at t. A vertex is
+	// scanned again only when its arrival function improves, and they are scanned by their earliest arrival (like a
+	// Dijkstra, but labels may be corrected because the functions are not totally ordered).
+	// The searches are independent, so they are run concurrently and share the (read only) arriving times.
+	parallel_for(m, [&] (int task) {
+		Vertex v = sources[task];
+		vector<PWLFunction> arrival(n); // arrival[w] = earliest arrival at w (empty if it is not reachable yet).
+		vector<bool> queued(n, false); // queued[w] = w is in the queue.
+		priority_queue<pair<double, Vertex>, vector<pair<double, Vertex>>, greater<pair<double, Vertex>>> q;
+		arrival[v] = PWLFunction::IdentityFunction(horizon);
+		q.push({horizon.left, v});
+		queued[v] = true;
+		while (!q.empty())
+		{
+			Vertex u = q.top().second;
+			q.pop();
+			queued[u] = false;
+			for (int k = arriving_times.Begin(u); k < arriving_times.End(u); ++k)
+			{
+				Vertex w = arriving_times.Head(k);
+				PWLFunction through_u = arriving_times.At(k).Compose(arrival[u]);
+				if (through_u.Empty()) continue;
+				PWLFunction improved = Min(arrival[w], through_u);
+				if (improved == arrival[w]) continue;
+				arrival[w] = improved;
+				if (!queued[w]) q.push({arrival[w].Image().left, w}), queued[w] = true;
 			}
 		}
-	}
-
-	Matrix<PWLFunction> zzzz(D.VertexCount(), D.VertexCount());
-	for (Vertex v : D.Vertices()) {
-		for (Vertex w : D.Vertices()) {
-			zzzz[v][w] = xxxx[v][w] - PWLFunction::IdentityFunction(xxxx[v][w].Domain());
-		}
-	}
-
-	return zzzz;
+		
+		// The travel time is the arrival time minus the departure time.
+		for (Vertex w: D.Vertices())
+			quickest[task][w] = arrival[w] - PWLFunction::IdentityFunction(arrival[w].Domain());
+	});
+	return quickest;
 }
 
+Matrix<PWLFunction> quickest_paths(const Digraph& D, const Matrix<PWLFunction>& arriving_times, Interval horizon)
+{
+	ArcTable<PWLFunction> arriving_times_table(D);
+	for (Arc e: D.Arcs()) arriving_times_table[e.tail][e.head] = arriving_times[e.tail][e.head];
+	return quickest_paths(D, arriving_times_table, horizon, D.Vertices());
+}
 
-void preprocess_travel_times(json& instance)
+void preprocess_travel_times(VRPInstanceBuilder& instance)
 {
-	Digraph D = instance["digraph"];
-	Matrix<PWLFunction> arriving_times(D.VertexCount(), D.VertexCount());
-	for (Arc e: D.Arcs()) {
-		PWLFunction tau = compute_travel_time_function(instance, e);
-		arriving_times[e.tail][e.head] = tau + PWLFunction::IdentityFunction(tau.Domain());
+	Digraph& D = instance.D;
+	ArcTable<PWLFunction> arriving_times(D);
+	// The arriving time of an arc only depends on its cluster and distance, so it is computed once for each pair.
+	map<pair<int, double>, PWLFunction> arriving_time_of;
+	for (Arc e: D.Arcs())
+	{
+		pair<int, double> key(instance.clusters[e.tail][e.head], instance.distances[e.tail][e.head]);
+		if (!arriving_time_of.count(key))
+		{
+			PWLFunction tau = compute_travel_time_function(instance, e);
+			arriving_time_of[key] = tau + PWLFunction::IdentityFunction(tau.Domain());
+		}
+		arriving_times[e.tail][e.head] = arriving_time_of[key];
 	}
-
-	instance["travel_times"] = quickest_paths(D, arriving_times, instance["horizon"]);
+	
+	instance.tau = quickest_paths(D, arriving_times, instance.horizon, D.Vertices());
 }
 } // namespace networks2019
\ No newline at end of file
@@ -16,31 +16,43 @@ namespace networks2019
 {
 namespace
 {
-// Removes the arc ij from the instance.
-void remove_arc(Vertex i, Vertex j, json& instance)
+// Returns: the travel time for arc e if departing at t0 (waiting if t0 is before the domain of tau_e).
+// If departure at t0 is infeasible, returns INFTY.
+TimeUnit travel_time(const PWLFunction& tau_e, TimeUnit t0)
 {
-	if (instance["digraph"]["arcs"][i][j] == 0) return;
-	instance["digraph"]["arcs"][i][j] = 0;
-	int arc_count = instance["digraph"]["arc_count"];
-	instance["digraph"]["arc_count"] = arc_count - 1;
-	if (has_key(instance, "travel_times")) instance["travel_times"][i][j] = vector<json>({});
+	if (epsilon_bigger(t0, max(dom(tau_e)))) return INFTY;
+	else if (epsilon_smaller(t0, min(dom(tau_e)))) return min(dom(tau_e))+tau_e.Value(min(dom(tau_e)))-t0;
+	return tau_e.Value(t0);
 }
 }
 
-void preprocess_triangle_depot(json& instance)
+bool is_dominated_by_depot(const VRPInstanceBuilder& instance, Arc e)
 {
-	VRPInstance vrp = instance;
-	Vertex o = vrp.o, d = vrp.d;
-	for (Vertex i: vrp.D.Vertices())
-	{
-		for (Vertex j: vrp.D.Successors(i))
-		{
-			if (i == o || j == d) continue;
-			TimeUnit b_i = max(vrp.tw[i]), a_j = min(vrp.tw[j]);
-			double t0_ij = vrp.TravelTime({i, d}, b_i) + vrp.TravelTime({o, j}, vrp.ArrivalTime({i, d}, b_i));
-			if (epsilon_smaller_equal(t0_ij, a_j - b_i))
-				remove_arc(i, j, instance);
-		}
-	}
+	const Digraph& D = instance.D;
+	Vertex o = instance.o, d = instance.d, i = e.tail, j = e.head;
+	if (i == o || j == d) return false;
+	
+	// Travel time function of (u, v) as in the VRPInstance built (for (u, u) the one for boundary reasons).
+	PWLFunction loop;
+	auto tau = [&] (Vertex u, Vertex v) -> const PWLFunction& {
+		static const PWLFunction none;
+		if (u == v) return loop = PWLFunction::ConstantFunction(0.0, instance.tw[u]);
+		return D.IncludesArc({u, v}) ? instance.tau[u][v] : none;
+	};
+	
+	// Departing from i at b_i, the arrival at the depot is b_i plus the travel time (waiting included).
+	TimeUnit b_i = max(instance.tw[i]), a_j = min(instance.tw[j]);
+	TimeUnit tau_id = travel_time(tau(i, d), b_i);
+	TimeUnit t0_ij = tau_id + travel_time(tau(o, j), tau_id == INFTY ? INFTY : b_i + tau_id);
+	return epsilon_smaller_equal(t0_ij, a_j - b_i);
+}
+
+void preprocess_triangle_depot(VRPInstanceBuilder& instance)
+{
+	vector<Arc> removed;
+	for (Arc e: instance.D.Arcs())
+		if (is_dominated_by_depot(instance, e))
+			removed.push_back(e);
+	instance.RemoveArcs(removed);
 }
 } // namespace networks2019
\ No newline at end of file
@@ -0,0 +1,44 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "tdcarp/tdcarp_instance.h"
+
+using namespace std;
+using namespace goc;
+using namespace nlohmann;
+
+namespace networks2019
+{
+void TDCARPInstance::SetAttributes(const json& attributes)
+{
+	depot = attributes["depot"];
+	horizon = attributes["horizon"];
+	service_speed_factor = attributes["service_speed_factor"];
+	capacity = attributes["capacity"];
+}
+
+void from_json(const json& j, TDCARPEdge& edge)
+{
+	edge.tail = j["tail"];
+	edge.head = j["head"];
+	edge.distance = j["distance"];
+	edge.demand = j["demand"];
+	edge.piece_ends.clear();
+	edge.speeds.clear();
+	for (auto& piece: j["travel_time"])
+	{
+		edge.piece_ends.push_back(piece["piece_end"]);
+		edge.speeds.push_back(piece["speed"]);
+	}
+}
+
+void from_json(const json& j, TDCARPInstance& instance)
+{
+	instance.vertex_count = j["graph"]["vertex_count"];
+	instance.edges = vector<TDCARPEdge>(j["graph"]["edges"].begin(), j["graph"]["edges"].end());
+	instance.SetAttributes(j);
+}
+} // namespace networks2019
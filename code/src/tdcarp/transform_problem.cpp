@@ -6,6 +6,10 @@
 
 #include "tdcarp/transform_problem.h"
 
+#include <map>
+
+#include "preprocess/preprocess_travel_times.h"
+
 using namespace std;
 using namespace goc;
 using namespace nlohmann;
@@ -105,146 +109,138 @@ PWLFunction compute_travel_time_function(double dist, const PWLFunction& speed_f
 	return tau;
 }
 
-Matrix<PWLFunction> quickest_paths(Digraph D, Matrix<PWLFunction> travel_times, Interval horizon)
+// Returns: the travel time function of each edge of the instance (they are independent, so they are computed
+// concurrently).
+vector<PWLFunction> compute_edge_travel_times(const TDCARPInstance& instance)
 {
-	// Calculate arriving times
-	Matrix<PWLFunction> arriving_times;
-	for (Arc e: D.Arcs()) {
-		PWLFunction& tau = travel_times[e.tail][e.head];
-		arriving_times[e.tail][e.head] = tau + PWLFunction::IdentityFunction(tau.Domain());
-	}
-
-	// Quickest paths algorithm
-	Matrix<PWLFunction> xxxx(D.VertexCount(), D.VertexCount());
-	for (Vertex v : D.Vertices()) {
-		auto& xx = xxxx[v];
-		for (Vertex w : D.Vertices()) {
-			if (w == v) {
-				xx[w] = PWLFunction::IdentityFunction(horizon);
-			} else {
-				// Empty PWLFunction
-			}
-		}
-
-		for (int i = 0; i <= D.VertexCount(); i++) { // Could be done better
-			for (Vertex from : D.Vertices()) {
-				for (Arc e : D.OutboundArcs(from)) {
-					auto yy = arriving_times[e.tail][e.head].Compose(xx[e.tail]);
-					xx[e.head] = Min(xx[e.head], yy);
-				}
-			}
-		}
-	}
-
-	Matrix<PWLFunction> zzzz(D.VertexCount(), D.VertexCount());
-	for (Vertex v : D.Vertices()) {
-		for (Vertex w : D.Vertices()) {
-			zzzz[v][w] = xxxx[v][w] - PWLFunction::IdentityFunction(xxxx[v][w].Domain());
+	int m = instance.edges.size();
+	vector<PWLFunction> edge_travel_times(m);
+	parallel_for(m, [&] (int k) {
+		const TDCARPEdge& e = instance.edges[k];
+		PWLFunction speed_function;
+		double piece_start = instance.horizon.left;
+		for (int p = 0; p < (int)e.piece_ends.size(); ++p)
+		{
+			speed_function.AddPiece(LinearFunction({piece_start, e.speeds[p]}, {e.piece_ends[p], e.speeds[p]}));
+			piece_start = e.piece_ends[p];
 		}
-	}
-
-	return zzzz;
+		edge_travel_times[k] = compute_travel_time_function(e.distance, speed_function);
+	});
+	return edge_travel_times;
 }
-
 }
 
-nlohmann::json transform_problem(nlohmann::json& instance)
+VRPInstanceBuilder transform_problem(const TDCARPInstance& instance, TransformationLog* log)
 {
-	json res;
-
-	// Input digraph and travel times
-    Digraph original_digraph((int) instance["graph"]["vertex_count"]);
-    Matrix<PWLFunction> original_travel_times(original_digraph.VertexCount(), original_digraph.VertexCount());
-    for (auto& e : instance["graph"]["edges"]) {
-        original_digraph.AddArc({e["tail"], e["head"]});
-
-		PWLFunction speed_function;
-        int piece_start = instance["horizon"];
-        for (auto& piece : e["travel_time"]) {
-			speed_function.AddPiece(LinearFunction({(double) piece_start, e["speed"]}, {e["piece_end"], e["speed"]}));
-			piece_start = e["piece_end"];
-        }
-        original_travel_times[e["tail"]][e["head"]] = compute_travel_time_function(e["distance"], speed_function);
-    }
-
-	Matrix<PWLFunction> quickest = quickest_paths(original_digraph, original_travel_times, instance["horizon"]);
-
+	// lap() returns the time since the previous lap (or the start).
+	Stopwatch rolex(true), stage_rolex(true);
+	auto lap = [&] () { Duration d = stage_rolex.Pause(); stage_rolex.Reset().Resume(); return d; };
+	
+	// Travel time function of each edge of the road network.
+	int m = instance.edges.size();
+	vector<PWLFunction> edge_travel_times = compute_edge_travel_times(instance);
+	
+	// Sparse road network, the arriving times are stored once per arc and shared by all the profile searches (parallel
+	// edges keep the earliest arrival).
+	Digraph road(instance.vertex_count);
+	for (auto& e: instance.edges) road.AddArc({e.tail, e.head});
+	ArcTable<PWLFunction> arriving_times(road);
+	for (int k = 0; k < m; ++k)
+	{
+		const TDCARPEdge& e = instance.edges[k];
+		const PWLFunction& tau = edge_travel_times[k];
+		PWLFunction arr = tau + PWLFunction::IdentityFunction(tau.Domain());
+		PWLFunction& arr_e = arriving_times[e.tail][e.head];
+		arr_e = arr_e.Empty() ? arr : Min(arr_e, arr);
+	}
+	Duration travel_times_time = lap();
+	
 	// Group edges with demand by their incident node set
-    map<pair<int, int>, vector<json>> xxx;
-    for (auto& e : instance["graph"]["edges"]) {
-        if (e["demand"] > 0) {
-            int tail = e["tail"];
-            int head = e["head"];
-            xxx[make_pair(min(tail, head), max(tail, head))].push_back(e);
-        }
-    }
-
+	map<pair<int, int>, vector<int>> xxx;
+	for (int k = 0; k < m; ++k)
+	{
+		const TDCARPEdge& e = instance.edges[k];
+		if (e.demand > 0) xxx[make_pair(min(e.tail, e.head), max(e.tail, e.head))].push_back(k);
+	}
+	
 	// Arbitrarily pick edges to serve
-	vector<json> serviced_edges;
-	for (auto& kv : xxx) {
+	vector<int> serviced_edges;
+	for (auto& kv: xxx)
+	{
 		int node_a = kv.first.first;
-		vector<json> edges = kv.second;
+		auto& edges = kv.second;
 		serviced_edges.push_back((node_a % 3 == 0) ? edges[0] : edges[1]);
 	}
-
-	// Make digraph
-	int n = serviced_edges.size() + 2; // start_depot = 0; end_depot = n-1
-	Digraph D(n);
-	for (int i = 1; i < n-1; i++) {
-		D.AddArc({0, i});
-		D.AddArc({i, n-1});
-		for (int j = 1; j < n-1; j++) if (i != j) {
-			D.AddArc({i, j});
-		}
-	}
-
-	// Travel times (with service time included)
-	Matrix<PWLFunction> travel_times(D.VertexCount(), D.VertexCount());
-	for (int i = 1; i < n-1; i++) {
-		json& e = serviced_edges[i-1];
-		auto service_time = [=] (json& ed) { return original_travel_times[e["tail"]][e["head"]] * (double) instance["service_speed_factor"]; }; 
-		travel_times[0][i] = original_travel_times[instance["depot"]][e["tail"]] + service_time(e);
-		travel_times[i][n-1] = original_travel_times[e["head"]][instance["depot"]]; 
-		for (int j = 1; j < n-1; j++) if (i != j) {
-			json& to = serviced_edges[j-1];
-			travel_times[i][j] = quickest[e["head"]][to["tail"]] + service_time(to);
-		}
-	}
-
-	// Marshalling
-    res["capacity"] = instance["capacity"];
-    res["instance_name"] = instance["instance_name"];
-    res["vehicle_count"] = instance["vehicle_count"];
-    res["horizon"] = instance["horizon"];
-	res["start_depot"] = 0;
-    res["end_depot"] = n-1;
-	res["time_windows"] = json::array();
-    for (int i = 0; i < n; i++) {
-        res["time_windows"].push_back( json::array({res["horizon"][0], res["horizon"][1]}) );
-    }
-	res["digraph"]["vertex_count"] = D.VertexCount();
-	res["digraph"]["arc_count"] = D.ArcCount();
-	res["digraph"]["arcs"] = Matrix<int>(D.VertexCount(), D.VertexCount());
-	for(int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			res["digraph"]["arcs"][i][j] = (D.IncludesArc({i, j})) ? 1 : 0;
-		}
+	
+	// Quickest paths are only needed from the depot and the heads of the serviced edges, source[v] is the index of
+	// vertex v in the sources (or -1 if it is not a source).
+	vector<Vertex> sources = {instance.depot};
+	vector<int> source(instance.vertex_count, -1);
+	source[instance.depot] = 0;
+	for (int k: serviced_edges)
+	{
+		Vertex v = instance.edges[k].head;
+		if (source[v] == -1) source[v] = sources.size(), sources.push_back(v);
 	}
-	res["travel_times"] = travel_times;
-	res["demands"] = json::array();
-	res["demands"].push_back(0); // start_depot
-	for (int i = 1; i < n-1; i++) {
-		res["demands"].push_back(serviced_edges[i-1]["demand"]);
+	Matrix<PWLFunction> quickest = quickest_paths(road, arriving_times, instance.horizon, sources);
+	Duration quickest_paths_time = lap();
+	
+	// Travel times (with service time included), the vertices are connected when their travel time is not empty.
+	// The service of edge j starts when its tail is reached, so its arrival function is composed with the one of the
+	// path (this keeps the FIFO property).
+	int n = serviced_edges.size() + 2; // start_depot = 0; end_depot = n-1
+	auto edge = [&] (int i) -> const TDCARPEdge& { return instance.edges[serviced_edges[i-1]]; };
+	vector<PWLFunction> service_arrival(n);
+	for (int i = 1; i < n-1; i++)
+	{
+		PWLFunction service_time = edge_travel_times[serviced_edges[i-1]] * instance.service_speed_factor;
+		service_arrival[i] = service_time + PWLFunction::IdentityFunction(service_time.Domain());
 	}
-	res["demands"].push_back(0); // end_depot
-	res["service_times"] = json::array(); // already included in travel_times
-	for (int i = 0; i < n; i++) {
-		res["service_times"].push_back(0);
+	auto travel_and_serve = [&] (const PWLFunction& path_time, int j) {
+		PWLFunction arrival = service_arrival[j].Compose(path_time + PWLFunction::IdentityFunction(path_time.Domain()));
+		return arrival - PWLFunction::IdentityFunction(arrival.Domain());
+	};
+	VRPInstanceBuilder builder;
+	builder.tau = Matrix<PWLFunction>(n, n);
+	parallel_for(n-2, [&] (int task) {
+		int i = task+1;
+		const TDCARPEdge& e = edge(i);
+		builder.tau[0][i] = travel_and_serve(quickest[0][e.tail], i);
+		builder.tau[i][n-1] = quickest[source[e.head]][instance.depot];
+		for (int j = 1; j < n-1; j++)
+			if (i != j) builder.tau[i][j] = travel_and_serve(quickest[source[e.head]][edge(j).tail], j);
+	});
+	builder.D = Digraph(n);
+	for (int i = 0; i < n; i++)
+		for (int j = 0; j < n; j++)
+			if (!builder.tau[i][j].Empty()) builder.D.AddArc({i, j});
+	Duration digraph_time = lap();
+	
+	// Remaining attributes
+	builder.o = 0;
+	builder.d = n-1;
+	builder.horizon = instance.horizon;
+	builder.tw = vector<Interval>(n, instance.horizon);
+	builder.s = vector<TimeUnit>(n, 0.0); // already included in travel_times
+	builder.Q = instance.capacity;
+	builder.q = vector<CapacityUnit>(n, 0.0); // depots have no demand
+	for (int i = 1; i < n-1; i++) builder.q[i] = edge(i).demand;
+	
+	if (log)
+	{
+		log->time = rolex.Pause();
+		log->travel_times_time = travel_times_time;
+		log->quickest_paths_time = quickest_paths_time;
+		log->digraph_time = digraph_time;
 	}
+	return builder;
+}
 
-	//res["digraph"]["coordinates"] // unused
-    //res["distances"] // already included in travel_times
-
-    return res;
+void to_json(json& j, const TransformationLog& log)
+{
+	j["time"] = log.time;
+	j["travel_times_time"] = log.travel_times_time;
+	j["quickest_paths_time"] = log.quickest_paths_time;
+	j["digraph_time"] = log.digraph_time;
 }
 } // namespace networks2019
\ No newline at end of file
@@ -6,6 +6,11 @@
 
 #include "vrp_instance.h"
 
+#include <algorithm>
+#include <functional>
+
+#include "vrp_instance_builder.h"
+
 using namespace std;
 using namespace goc;
 using namespace nlohmann;
@@ -75,18 +80,41 @@ Route VRPInstance::BestDurationRoute(const GraphPath& p) const
 
 VertexSet VRPInstance::Unreachable(Vertex v, TimeUnit t0) const
 {
-	VertexSet U;
-	for (Vertex w: D.Vertices()) if (epsilon_bigger(t0, LDT[v][w])) U.set(w);
-	return U;
+	// Vertices w with epsilon_bigger(t0, LDT[v][w]) are a prefix of the vertices sorted by LDT[v][w].
+	auto& L = ldt_sorted_[v];
+	return ldt_prefix_[v][lower_bound(L.begin(), L.end(), t0 - EPS) - L.begin()];
 }
 
 VertexSet VRPInstance::WeakUnreachable(goc::Vertex v, TimeUnit t0) const
 {
-	VertexSet U;
 	double min_tt = INFTY;
 	for (Vertex w: D.Successors(v)) min_tt = min(min_tt, TravelTime({v,w}, t0));
-	for (Vertex w: D.Vertices()) if (epsilon_bigger(t0+min_tt, tw[w].right)) U.set(w);
-	return U;
+	// Vertices w with epsilon_bigger(t0+min_tt, b(w)) are a prefix of the vertices sorted by b(w).
+	return deadline_prefix_[lower_bound(deadline_sorted_.begin(), deadline_sorted_.end(), t0 + min_tt - EPS) - deadline_sorted_.begin()];
+}
+
+void VRPInstance::BuildUnreachableIndex()
+{
+	int n = D.VertexCount();
+	
+	// Builds the sorted keys and the prefix sets of the vertices sorted by key(w).
+	auto build_prefixes = [&] (const function<TimeUnit(Vertex)>& key, vector<TimeUnit>* sorted, vector<VertexSet>* prefix) {
+		vector<Vertex> V = D.Vertices();
+		stable_sort(V.begin(), V.end(), [&] (Vertex w1, Vertex w2) { return key(w1) < key(w2); });
+		sorted->resize(n);
+		prefix->assign(n+1, VertexSet());
+		for (int k = 0; k < n; ++k)
+		{
+			(*sorted)[k] = key(V[k]);
+			(*prefix)[k+1] = (*prefix)[k];
+			(*prefix)[k+1].set(V[k]);
+		}
+	};
+	
+	ldt_sorted_.assign(n, {});
+	ldt_prefix_.assign(n, {});
+	for (Vertex v: D.Vertices()) build_prefixes([&] (Vertex w) { return LDT[v][w]; }, &ldt_sorted_[v], &ldt_prefix_[v]);
+	build_prefixes([&] (Vertex w) { return tw[w].right; }, &deadline_sorted_, &deadline_prefix_);
 }
 
 void VRPInstance::Print(ostream& os) const
@@ -108,38 +136,6 @@ void to_json(json& j, const VRPInstance& instance)
 
 void from_json(const json& j, VRPInstance& instance)
 {
-	int n = j["digraph"]["vertex_count"];
-	instance.D = j["digraph"];
-	instance.o = j["start_depot"];
-	instance.d = j["end_depot"];
-	instance.T = j["horizon"][1];
-	instance.tw = vector<Interval>(j["time_windows"].begin(), j["time_windows"].end());
-	instance.Q = value_or_default(j, "capacity", 1.0);
-	instance.q = vector<CapacityUnit>(j["demands"].begin(), j["demands"].end());
-	// Add travel time functions.
-	instance.tau = instance.arr = instance.dep = instance.pretau = Matrix<PWLFunction>(n, n);
-	for (Vertex u: instance.D.Vertices())
-	{
-		for (Vertex v: instance.D.Successors(u))
-		{
-			instance.tau[u][v] = j["travel_times"][u][v];
-			instance.arr[u][v] = instance.tau[u][v] + PWLFunction::IdentityFunction(instance.tau[u][v].Domain());
-			instance.dep[u][v] = instance.arr[u][v].Inverse();
-			instance.pretau[u][v] = PWLFunction::IdentityFunction(instance.dep[u][v].Domain()) - instance.dep[u][v];
-		}
-	}
-	// Add travel functions for (i, i) (for boundary reasons).
-	for (Vertex u: instance.D.Vertices())
-	{
-		instance.tau[u][u] = instance.pretau[u][u] = PWLFunction::ConstantFunction(0.0, instance.tw[u]);
-		instance.dep[u][u] = instance.arr[u][u] = PWLFunction::IdentityFunction(instance.tw[u]);
-	}
-	// Set LDT.
-	instance.LDT = Matrix<TimeUnit>(n, n);
-	for (Vertex i: instance.D.Vertices())
-	{
-		vector<TimeUnit> LDT_i = compute_latest_departure_time(instance.D, i, instance.tw[i].right, [&] (Vertex u, Vertex v, double tf) { return instance.DepartureTime({u,v}, tf); });
-		for (Vertex k: instance.D.Vertices()) instance.LDT[k][i] = LDT_i[k];
-	}
+	instance = j.get<VRPInstanceBuilder>().Build();
 }
 } // namespace networks2019
\ No newline at end of file
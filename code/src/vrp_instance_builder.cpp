@@ -0,0 +1,93 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "vrp_instance_builder.h"
+
+using namespace std;
+using namespace goc;
+using namespace nlohmann;
+
+namespace networks2019
+{
+void VRPInstanceBuilder::SetAttributes(const json& attributes)
+{
+	int n = D.VertexCount();
+	o = value_or_default(attributes, "start_depot", 0);
+	d = value_or_default(attributes, "end_depot", n-1);
+	horizon = attributes["horizon"];
+	Q = value_or_default(attributes, "capacity", 1.0);
+	if (tw.empty()) tw = vector<Interval>(n, horizon);
+	if (s.empty()) s = vector<TimeUnit>(n, 0.0);
+	if (q.empty()) q = vector<CapacityUnit>(n, 0.0);
+	if (tau.row_count() == 0) tau = Matrix<PWLFunction>(n, n);
+}
+
+void VRPInstanceBuilder::RemoveArc(Arc e)
+{
+	RemoveArcs({e});
+}
+
+void VRPInstanceBuilder::RemoveArcs(const vector<Arc>& arcs)
+{
+	for (Arc e: arcs)
+	{
+		if (!D.IncludesArc(e)) continue;
+		D.RemoveArc(e);
+		tau[e.tail][e.head] = PWLFunction();
+	}
+}
+
+VRPInstance VRPInstanceBuilder::Build() const
+{
+	int n = D.VertexCount();
+	VRPInstance instance;
+	instance.D = D;
+	instance.o = o;
+	instance.d = d;
+	instance.T = horizon.right;
+	instance.tw = tw;
+	instance.Q = Q;
+	instance.q = q;
+	// Add travel time functions. The rows of the functions and the LDT of each vertex are independent, so they are
+	// computed concurrently.
+	instance.tau = instance.arr = instance.dep = instance.pretau = ArcTable<PWLFunction>(D);
+	parallel_for(n, [&] (int u) {
+		for (Vertex v: D.Successors(u))
+		{
+			instance.tau[u][v] = tau[u][v];
+			instance.arr[u][v] = instance.tau[u][v] + PWLFunction::IdentityFunction(instance.tau[u][v].Domain());
+			instance.dep[u][v] = instance.arr[u][v].Inverse();
+			instance.pretau[u][v] = PWLFunction::IdentityFunction(instance.dep[u][v].Domain()) - instance.dep[u][v];
+		}
+		// Add travel functions for (u, u) (for boundary reasons).
+		instance.tau[u][u] = instance.pretau[u][u] = PWLFunction::ConstantFunction(0.0, instance.tw[u]);
+		instance.dep[u][u] = instance.arr[u][u] = PWLFunction::IdentityFunction(instance.tw[u]);
+	});
+	// Set LDT.
+	instance.LDT = Matrix<TimeUnit>(n, n);
+	parallel_for(n, [&] (int i) {
+		vector<TimeUnit> LDT_i = compute_latest_departure_time(D, i, instance.tw[i].right, [&] (Vertex u, Vertex v, double tf) { return instance.DepartureTime({u,v}, tf); });
+		for (Vertex k: D.Vertices()) instance.LDT[k][i] = LDT_i[k];
+	});
+	instance.BuildUnreachableIndex();
+	return instance;
+}
+
+void from_json(const json& j, VRPInstanceBuilder& builder)
+{
+	builder.D = j["digraph"];
+	if (has_key(j, "time_windows")) builder.tw = vector<Interval>(j["time_windows"].begin(), j["time_windows"].end());
+	if (has_key(j, "service_times")) builder.s = vector<TimeUnit>(j["service_times"].begin(), j["service_times"].end());
+	if (has_key(j, "demands")) builder.q = vector<CapacityUnit>(j["demands"].begin(), j["demands"].end());
+	if (has_key(j, "travel_times")) builder.tau = j["travel_times"];
+	// Attributes of the speed model, only present if the travel times must be computed.
+	if (has_key(j, "distances")) builder.distances = j["distances"];
+	if (has_key(j, "clusters")) builder.clusters = j["clusters"];
+	if (has_key(j, "cluster_speeds")) builder.cluster_speeds = j["cluster_speeds"].get<vector<vector<double>>>();
+	if (has_key(j, "speed_zones")) builder.speed_zones = vector<Interval>(j["speed_zones"].begin(), j["speed_zones"].end());
+	builder.SetAttributes(j);
+}
+} // namespace networks2019
@@ -0,0 +1,257 @@
+//
+// Created by Gonzalo Lera Romero.
+// Grupo de Optimizacion Combinatoria (GOC).
+// Departamento de Computacion - Universidad de Buenos Aires.
+//
+
+#include "vrp_snapshot.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace goc;
+
+namespace networks2019
+{
+namespace
+{
+const char MAGIC[8] = "VRPSNAP"; // identifies the snapshot files.
+const uint32_t VERSION = 4; // must be increased when the format changes.
+
+struct Header
+{
+	char magic[8];
+	uint32_t version;
+	double breakpoint_tolerance;
+	uint64_t payload_size;
+	uint64_t checksum;
+};
+
+// Returns: the FNV-1a hash of the bytes.
+uint64_t checksum(const char* bytes, size_t size)
+{
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i) h = (h ^ (unsigned char)bytes[i]) * 1099511628211ull;
+	return h;
+}
+
+// Appends the binary representation of the values to a buffer.
+class Writer
+{
+public:
+	vector<char> buffer;
+	
+	template<typename T>
+	void Write(const T& value)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+	
+	void Write(const string& s)
+	{
+		Write<uint32_t>(s.size());
+		buffer.insert(buffer.end(), s.begin(), s.end());
+	}
+	
+	void Write(const PWLFunction& f)
+	{
+		Write<uint32_t>(f.PieceCount());
+		for (auto& p: f.Pieces())
+			for (double x: {p.domain.left, p.domain.right, p.image.left, p.image.right, p.slope, p.intercept})
+				Write(x);
+	}
+	
+	void Write(const VRPInstance& vrp)
+	{
+		int n = vrp.D.VertexCount();
+		Write<int32_t>(n);
+		Write<int32_t>(vrp.o);
+		Write<int32_t>(vrp.d);
+		Write<double>(vrp.T);
+		Write<double>(vrp.Q);
+		Write<uint32_t>(vrp.D.ArcCount());
+		for (Arc e: vrp.D.Arcs()) { Write<int32_t>(e.tail); Write<int32_t>(e.head); }
+		for (Vertex i = 0; i < n; ++i) { Write<double>(vrp.tw[i].left); Write<double>(vrp.tw[i].right); }
+		for (Vertex i = 0; i < n; ++i) Write<double>(vrp.q[i]);
+		for (auto* F: {&vrp.tau, &vrp.arr, &vrp.dep, &vrp.pretau})
+		{
+			for (Vertex i = 0; i < n; ++i) Write(F->Loop(i));
+			for (int k = 0; k < F->ArcCount(); ++k) Write(F->At(k));
+		}
+		for (Vertex i = 0; i < n; ++i)
+			for (Vertex j = 0; j < n; ++j)
+				Write<double>(vrp.LDT[i][j]);
+	}
+};
+
+// Reads values from the binary representation in a memory region.
+class Reader
+{
+public:
+	Reader(const char* begin, const char* end) : current_(begin), end_(end)
+	{
+	
+	}
+	
+	template<typename T>
+	T Read()
+	{
+		if (end_ - current_ < (ptrdiff_t)sizeof(T)) fail("The snapshot is truncated.");
+		T value;
+		memcpy(&value, current_, sizeof(T));
+		current_ += sizeof(T);
+		return value;
+	}
+	
+	string ReadString()
+	{
+		uint32_t size = Read<uint32_t>();
+		if (end_ - current_ < (ptrdiff_t)size) fail("The snapshot is truncated.");
+		string s(current_, current_ + size);
+		current_ += size;
+		return s;
+	}
+	
+	PWLFunction ReadPWLFunction()
+	{
+		uint32_t piece_count = Read<uint32_t>();
+		vector<LinearFunction> pieces(piece_count);
+		for (auto& p: pieces)
+		{
+			p.domain.left = Read<double>();
+			p.domain.right = Read<double>();
+			p.image.left = Read<double>();
+			p.image.right = Read<double>();
+			p.slope = Read<double>();
+			p.intercept = Read<double>();
+		}
+		return PWLFunction(pieces);
+	}
+	
+	void ReadVRPInstance(VRPInstance* vrp)
+	{
+		int n = Read<int32_t>();
+		vrp->o = Read<int32_t>();
+		vrp->d = Read<int32_t>();
+		vrp->T = Read<double>();
+		vrp->Q = Read<double>();
+		vrp->D = Digraph(n);
+		uint32_t arc_count = Read<uint32_t>();
+		for (uint32_t k = 0; k < arc_count; ++k)
+		{
+			Vertex tail = Read<int32_t>();
+			Vertex head = Read<int32_t>();
+			vrp->D.AddArc({tail, head});
+		}
+		vrp->tw.resize(n);
+		for (Vertex i = 0; i < n; ++i) { vrp->tw[i].left = Read<double>(); vrp->tw[i].right = Read<double>(); }
+		vrp->q.resize(n);
+		for (Vertex i = 0; i < n; ++i) vrp->q[i] = Read<double>();
+		for (auto* F: {&vrp->tau, &vrp->arr, &vrp->dep, &vrp->pretau})
+		{
+			*F = ArcTable<PWLFunction>(vrp->D);
+			for (Vertex i = 0; i < n; ++i) F->Loop(i) = ReadPWLFunction();
+			for (int k = 0; k < F->ArcCount(); ++k) F->At(k) = ReadPWLFunction();
+		}
+		vrp->LDT = Matrix<TimeUnit>(n, n);
+		for (Vertex i = 0; i < n; ++i)
+			for (Vertex j = 0; j < n; ++j)
+				vrp->LDT[i][j] = Read<double>();
+		vrp->BuildUnreachableIndex();
+	}
+
+private:
+	const char* current_; // next byte to read.
+	const char* end_; // end of the memory region.
+};
+
+// File mapped into memory, it is unmapped when it goes out of scope.
+class MappedFile
+{
+public:
+	const char* data; // first byte of the file (nullptr if it could not be mapped).
+	size_t size; // number of bytes of the file.
+	
+	explicit MappedFile(const string& path) : data(nullptr), size(0), fd_(open(path.c_str(), O_RDONLY))
+	{
+		struct stat file_stat;
+		if (fd_ < 0 || fstat(fd_, &file_stat) != 0 || file_stat.st_size == 0) return;
+		size = file_stat.st_size;
+		void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (address != MAP_FAILED) data = static_cast<const char*>(address);
+	}
+	
+	~MappedFile()
+	{
+		if (data) munmap(const_cast<char*>(data), size);
+		if (fd_ >= 0) close(fd_);
+	}
+
+private:
+	int fd_; // file descriptor.
+};
+}
+
+bool snapshot_exists(const string& path)
+{
+	struct stat file_stat;
+	return stat(path.c_str(), &file_stat) == 0;
+}
+
+void save_snapshot(const string& path, const string& instance_name, double breakpoint_tolerance,
+	const BreakpointReduction& breakpoint_reduction, const VRPInstance& vrp, const VRPInstance& reverse_vrp)
+{
+	Writer payload;
+	payload.Write(instance_name);
+	payload.Write<int32_t>(breakpoint_reduction.piece_count_before);
+	payload.Write<int32_t>(breakpoint_reduction.piece_count_after);
+	payload.Write(vrp);
+	payload.Write(reverse_vrp);
+	
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.breakpoint_tolerance = breakpoint_tolerance;
+	header.payload_size = payload.buffer.size();
+	header.checksum = checksum(payload.buffer.data(), payload.buffer.size());
+	
+	ofstream file(path, ios::binary);
+	if (!file.good()) fail("The snapshot file " + path + " can not be written.");
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(payload.buffer.data(), payload.buffer.size());
+}
+
+void load_snapshot(const string& path, const string& instance_name, double breakpoint_tolerance,
+	BreakpointReduction* breakpoint_reduction, VRPInstance* vrp, VRPInstance* reverse_vrp)
+{
+	MappedFile file(path);
+	if (!file.data) fail("The snapshot file " + path + " can not be mapped.");
+	if (file.size < sizeof(Header)) fail("The snapshot is truncated.");
+	Header header;
+	memcpy(&header, file.data, sizeof(Header));
+	if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) fail("The file " + path + " is not a snapshot.");
+	if (header.version != VERSION) fail("The snapshot version " + STR(header.version) + " is not supported.");
+	if (header.breakpoint_tolerance != breakpoint_tolerance)
+		fail("The snapshot was preprocessed with breakpoint tolerance " + STR(header.breakpoint_tolerance) + ", not " +
+			STR(breakpoint_tolerance) + ".");
+	const char* payload = file.data + sizeof(Header);
+	if (file.size - sizeof(Header) != header.payload_size) fail("The snapshot is truncated.");
+	if (checksum(payload, header.payload_size) != header.checksum) fail("The snapshot is corrupted.");
+	
+	Reader reader(payload, payload + header.payload_size);
+	string name = reader.ReadString();
+	if (name != instance_name) fail("The snapshot belongs to the instance " + name + ", not to " + instance_name + ".");
+	breakpoint_reduction->piece_count_before = reader.Read<int32_t>();
+	breakpoint_reduction->piece_count_after = reader.Read<int32_t>();
+	reader.ReadVRPInstance(vrp);
+	reader.ReadVRPInstance(reverse_vrp);
+}
+} // namespace networks2019
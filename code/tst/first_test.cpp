@@ -1,9 +1,15 @@
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <goc/goc.h>
 #include <gtest/gtest.h>
 
+#include "instance_reader.h"
+#include "labeling/bidirectional_labeling.h"
 #include "preprocess/preprocess_travel_times.h"
+#include "vrp_snapshot.h"
 
 using namespace networks2019;
 using namespace goc;
@@ -27,9 +33,10 @@ TEST(FirstTest, Dummy) {
     j["clusters"] = { {0, 0, 0}, {0, 0, 0}, {0, 0, 0} };
     j["cluster_speeds"] = { {1} };
 
-    preprocess_travel_times(j);
+    VRPInstanceBuilder instance = j;
+    preprocess_travel_times(instance);
 
-    goc::Matrix<goc::PWLFunction> m = j["travel_times"];
+    goc::Matrix<goc::PWLFunction> m = instance.tau;
     ASSERT_FALSE(m[0][2].Empty());
     ASSERT_TRUE(m[2][0].Empty());
 
@@ -136,6 +143,304 @@ TEST(FirstTest, Dummy4) {
     ASSERT_EQ(expected, res[0][3]);
 }
 
+// Returns: if f(x) <= g(x) <= f(x) + tolerance at the breakpoints of f and at the middle of its pieces.
+bool within_tolerance(const PWLFunction& f, const PWLFunction& g, double tolerance) {
+    for (auto& p: f.Pieces()) {
+        for (double x: {p.domain.left, (p.domain.left + p.domain.right) / 2, p.domain.right}) {
+            if (epsilon_smaller(g(x), f(x)) || epsilon_bigger(g(x), f(x) + tolerance)) return false;
+        }
+    }
+    return true;
+}
+
+TEST(FirstTest, SimplifyCollinear) {
+    //
+    // Three pieces through (0, 0), (10, 10), (20, 20.5), (30, 30).
+    // With tolerance 1 a single line from (0, 0) lies in the band, and the lowest one is taken (slope 1.025).
+    //
+
+    PWLFunction f;
+    f.AddPiece(LinearFunction(Point2D(0, 0), Point2D(10, 10)));
+    f.AddPiece(LinearFunction(Point2D(10, 10), Point2D(20, 20.5)));
+    f.AddPiece(LinearFunction(Point2D(20, 20.5), Point2D(30, 30)));
+
+    PWLFunction expected;
+    expected.AddPiece(LinearFunction(Point2D(0, 0), Point2D(30, 30.75)));
+    ASSERT_EQ(expected, f.Simplify(1.0));
+    ASSERT_EQ(f, f.Simplify(0.0));
+}
+
+TEST(FirstTest, SimplifyTolerance) {
+    //
+    // Zigzag between 0 and 2 with period 10.
+    // The simplification must stay between f and f + tolerance, with the same domain and not more pieces.
+    // With tolerance 2 it starts at f(0) = 0, rises to 2 and stays constant.
+    //
+
+    PWLFunction f;
+    for (int k = 0; k < 10; ++k) {
+        f.AddPiece(LinearFunction(Point2D(10*k, 0), Point2D(10*k + 5, 2)));
+        f.AddPiece(LinearFunction(Point2D(10*k + 5, 2), Point2D(10*k + 10, 0)));
+    }
+
+    for (double tolerance: {0.0, 0.5, 1.0, 2.0, 3.0}) {
+        PWLFunction g = f.Simplify(tolerance);
+        ASSERT_EQ(f.Domain(), g.Domain());
+        ASSERT_LE(g.PieceCount(), f.PieceCount());
+        ASSERT_TRUE(within_tolerance(f, g, tolerance));
+    }
+    ASSERT_EQ(2, f.Simplify(2.0).PieceCount());
+}
+
+TEST(FirstTest, SimplifyNonDecreasing) {
+    //
+    // Non decreasing arrival function with flat and nearly flat pieces.
+    // The lowest line may decrease, but the simplification must keep the function non decreasing.
+    //
+
+    PWLFunction f;
+    f.AddPiece(LinearFunction(Point2D(0, 10), Point2D(10, 20)));
+    f.AddPiece(LinearFunction(Point2D(10, 20), Point2D(20, 20)));
+    f.AddPiece(LinearFunction(Point2D(20, 20), Point2D(30, 20.5)));
+    f.AddPiece(LinearFunction(Point2D(30, 20.5), Point2D(40, 21)));
+    f.AddPiece(LinearFunction(Point2D(40, 21), Point2D(50, 40)));
+    f.AddPiece(LinearFunction(Point2D(50, 40), Point2D(60, 40.2)));
+
+    for (double tolerance: {0.1, 1.0, 5.0, 15.0}) {
+        PWLFunction g = f.Simplify(tolerance);
+        ASSERT_TRUE(within_tolerance(f, g, tolerance));
+        for (int i = 0; i < g.PieceCount(); ++i) {
+            ASSERT_FALSE(epsilon_smaller(g.Piece(i).slope, 0.0));
+            if (i > 0) {
+                ASSERT_FALSE(epsilon_smaller(g.Piece(i).Value(g.Piece(i).domain.left),
+                    g.Piece(i-1).Value(g.Piece(i-1).domain.right)));
+            }
+        }
+    }
+}
+
+TEST(FirstTest, SimplifyDiscontinuous) {
+    //
+    // Two nearly collinear runs with a jump at 20, and a gap between 40 and 50.
+    // Each run is merged on its own, so the jump and the gap are kept.
+    //
+
+    PWLFunction f;
+    f.AddPiece(LinearFunction(Point2D(0, 0), Point2D(10, 1)));
+    f.AddPiece(LinearFunction(Point2D(10, 1), Point2D(20, 2.2)));
+    f.AddPiece(LinearFunction(Point2D(20, 10), Point2D(30, 11)));
+    f.AddPiece(LinearFunction(Point2D(30, 11), Point2D(40, 11.8)));
+    f.AddPiece(LinearFunction(Point2D(50, 15), Point2D(60, 16)));
+
+    PWLFunction g = f.Simplify(0.5);
+    ASSERT_EQ(3, g.PieceCount());
+    ASSERT_TRUE(within_tolerance(f, g, 0.5));
+    ASSERT_EQ(Interval(0, 20), g.Piece(0).domain);
+    ASSERT_EQ(Interval(20, 40), g.Piece(1).domain);
+    ASSERT_EQ(Interval(50, 60), g.Piece(2).domain);
+    ASSERT_LE(g.Piece(0).Value(20), 2.7);
+    ASSERT_GE(g.Piece(1).Value(20), 10);
+}
+
+// Returns: a preprocessed instance with 5 vertices, two speed zones, and the arcs (1, 2) and (3, 1) removed.
+VRPInstance snapshot_instance() {
+    nlohmann::json j;
+    j["digraph"]["vertex_count"] = 5;
+    j["digraph"]["arcs"] = { {0, 1, 1, 1, 0}, {0, 0, 1, 1, 1}, {0, 1, 0, 1, 1}, {0, 1, 1, 0, 1}, {0, 0, 0, 0, 0} };
+    j["distances"] = { {0, 10, 20, 15, 0}, {0, 0, 12, 8, 10}, {0, 12, 0, 9, 20}, {0, 8, 9, 0, 15}, {0, 0, 0, 0, 0} };
+    j["horizon"] = { 0, 200 };
+    j["time_windows"] = { {0, 200}, {10, 60}, {30, 120}, {0, 90}, {0, 200} };
+    j["speed_zones"] = { {0, 50}, {50, 200} };
+    j["cluster_count"] = 2;
+    j["clusters"] = { {0, 0, 1, 0, 0}, {0, 0, 1, 1, 0}, {0, 1, 0, 1, 1}, {0, 1, 0, 0, 0}, {0, 0, 0, 0, 0} };
+    j["cluster_speeds"] = { {1, 0.5}, {0.5, 1} };
+
+    VRPInstanceBuilder builder = j;
+    preprocess_travel_times(builder);
+    builder.RemoveArcs({{1, 2}, {3, 1}});
+    return builder.Build();
+}
+
+// Checks that both instances have the same attributes, functions (in CSR order) and lookup structures.
+void expect_same_instance(const VRPInstance& a, const VRPInstance& b) {
+    int n = a.D.VertexCount();
+    ASSERT_EQ(n, b.D.VertexCount());
+    ASSERT_EQ(a.D.ArcCount(), b.D.ArcCount());
+    EXPECT_EQ(a.o, b.o);
+    EXPECT_EQ(a.d, b.d);
+    EXPECT_EQ(a.T, b.T);
+    EXPECT_EQ(a.Q, b.Q);
+    EXPECT_EQ(a.q, b.q);
+    for (Vertex v = 0; v < n; ++v) {
+        EXPECT_EQ(a.tw[v], b.tw[v]);
+        EXPECT_EQ(a.tau.Begin(v), b.tau.Begin(v));
+        EXPECT_EQ(a.tau.End(v), b.tau.End(v));
+        EXPECT_EQ(a.tau.Loop(v), b.tau.Loop(v));
+        EXPECT_EQ(a.arr.Loop(v), b.arr.Loop(v));
+        EXPECT_EQ(a.dep.Loop(v), b.dep.Loop(v));
+        EXPECT_EQ(a.pretau.Loop(v), b.pretau.Loop(v));
+        for (Vertex w = 0; w < n; ++w) EXPECT_EQ(a.LDT[v][w], b.LDT[v][w]);
+        for (double t = 0; t <= a.T; t += 5) {
+            EXPECT_EQ(a.Unreachable(v, t), b.Unreachable(v, t));
+            EXPECT_EQ(a.WeakUnreachable(v, t), b.WeakUnreachable(v, t));
+        }
+    }
+    for (int k = 0; k < a.tau.ArcCount(); ++k) {
+        EXPECT_EQ(a.tau.Head(k), b.tau.Head(k));
+        EXPECT_EQ(a.tau.At(k), b.tau.At(k));
+        EXPECT_EQ(a.arr.At(k), b.arr.At(k));
+        EXPECT_EQ(a.dep.At(k), b.dep.At(k));
+        EXPECT_EQ(a.pretau.At(k), b.pretau.At(k));
+    }
+}
+
+TEST(FirstTest, SnapshotRoundTrip) {
+    VRPInstance vrp = snapshot_instance(), reverse_vrp = reverse_instance(vrp);
+    std::string path = testing::TempDir() + "round_trip.snapshot";
+    BreakpointReduction reduction;
+    reduction.piece_count_before = 12;
+    reduction.piece_count_after = 7;
+    save_snapshot(path, "test", 0.5, reduction, vrp, reverse_vrp);
+
+    VRPInstance loaded, reverse_loaded;
+    BreakpointReduction loaded_reduction;
+    load_snapshot(path, "test", 0.5, &loaded_reduction, &loaded, &reverse_loaded);
+    ASSERT_EQ(12, loaded_reduction.piece_count_before);
+    ASSERT_EQ(7, loaded_reduction.piece_count_after);
+    ASSERT_EQ(-1, loaded.tau.ArcIndex({1, 2}));
+    ASSERT_EQ(-1, loaded.tau.ArcIndex({3, 1}));
+    expect_same_instance(vrp, loaded);
+    expect_same_instance(reverse_vrp, reverse_loaded);
+    std::remove(path.c_str());
+}
+
+TEST(FirstTest, SnapshotRejected) {
+    VRPInstance vrp = snapshot_instance(), reverse_vrp = reverse_instance(vrp);
+    std::string path = testing::TempDir() + "rejected.snapshot";
+    save_snapshot(path, "test", 0.0, BreakpointReduction(), vrp, reverse_vrp);
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    auto write = [&] (const std::string& content) { std::ofstream(path, std::ios::binary) << content; };
+
+    VRPInstance loaded, reverse_loaded;
+    BreakpointReduction reduction;
+    EXPECT_ANY_THROW(load_snapshot(path, "other", 0.0, &reduction, &loaded, &reverse_loaded));
+    EXPECT_ANY_THROW(load_snapshot(path, "test", 0.1, &reduction, &loaded, &reverse_loaded));
+
+    write(bytes.substr(0, bytes.size() / 2));
+    EXPECT_ANY_THROW(load_snapshot(path, "test", 0.0, &reduction, &loaded, &reverse_loaded));
+    write(bytes.substr(0, 10));
+    EXPECT_ANY_THROW(load_snapshot(path, "test", 0.0, &reduction, &loaded, &reverse_loaded));
+
+    std::string corrupted = bytes;
+    corrupted[corrupted.size() / 2] ^= 1;
+    write(corrupted);
+    EXPECT_ANY_THROW(load_snapshot(path, "test", 0.0, &reduction, &loaded, &reverse_loaded));
+
+    write(bytes);
+    EXPECT_NO_THROW(load_snapshot(path, "test", 0.0, &reduction, &loaded, &reverse_loaded));
+    std::remove(path.c_str());
+}
+
+TEST(FirstTest, ReadVRPInstance) {
+    //
+    // The streaming reader must give the same builder and attributes as parsing the document and using from_json.
+    //
+
+    std::string text = R"({
+        "instance_name": "inline", "capacity": 10, "horizon": [0, 100], "start_depot": 0, "end_depot": 2,
+        "profits": {"values": [1, 2.5, null], "enabled": true},
+        "digraph": {"vertex_count": 3, "arcs": [[0, 1, 1], [0, 0, 1], [0, 0, 0]]},
+        "travel_times": [[[], [[[0, 5], [50, 7]], [[50, 7], [90, 7]]], [[[0, 12], [80, 12]]]],
+                         [[], [], [[[0, 3.5], [95, 4]]]], [[], [], []]],
+        "time_windows": [[0, 100], [10, 60], [0, 100]],
+        "service_times": [0, 2, 0],
+        "demands": [0, 4, 0],
+        "distances": [[0, 5, 12], [5, 0, 3.5], [12, 3.5, 0]],
+        "clusters": [[0, 1, 0], [1, 0, 1], [0, 1, 0]],
+        "cluster_speeds": [[1, 0.5], [0.5, 1]],
+        "speed_zones": [[0, 50], [50, 100]]
+    })";
+    std::istringstream stream(text);
+    nlohmann::json attributes;
+    VRPInstanceBuilder read = read_vrp_instance(stream, &attributes);
+    nlohmann::json document = nlohmann::json::parse(text);
+    VRPInstanceBuilder converted = document;
+
+    for (auto& key: {"digraph", "travel_times", "time_windows", "service_times", "demands", "distances", "clusters",
+                     "cluster_speeds", "speed_zones"}) document.erase(key);
+    ASSERT_EQ(document, attributes);
+    ASSERT_EQ(converted.D.VertexCount(), read.D.VertexCount());
+    ASSERT_EQ(converted.D.ArcCount(), read.D.ArcCount());
+    for (Arc e: converted.D.Arcs()) ASSERT_TRUE(read.D.IncludesArc(e));
+    ASSERT_EQ(2, read.tau[0][1].PieceCount());
+    ASSERT_EQ(converted.o, read.o);
+    ASSERT_EQ(converted.d, read.d);
+    ASSERT_EQ(converted.horizon, read.horizon);
+    ASSERT_EQ(converted.Q, read.Q);
+    ASSERT_EQ(converted.tw, read.tw);
+    ASSERT_EQ(converted.s, read.s);
+    ASSERT_EQ(converted.q, read.q);
+    ASSERT_EQ(converted.cluster_speeds, read.cluster_speeds);
+    ASSERT_EQ(converted.speed_zones, read.speed_zones);
+    for (Vertex i = 0; i < 3; ++i) {
+        for (Vertex j = 0; j < 3; ++j) {
+            ASSERT_EQ(converted.tau[i][j], read.tau[i][j]);
+            ASSERT_EQ(converted.distances[i][j], read.distances[i][j]);
+            ASSERT_EQ(converted.clusters[i][j], read.clusters[i][j]);
+        }
+    }
+}
+
+TEST(FirstTest, ReadTDCARPInstance) {
+    //
+    // The streaming reader must give the same instance and attributes as parsing the document and using from_json.
+    //
+
+    std::string text = R"({
+        "instance_name": "inline", "vehicle_count": 2, "capacity": 30, "depot": 1, "horizon": [0, 100],
+        "service_speed_factor": 0.7,
+        "graph": {"vertex_count": 3, "arcs": [], "edges": [
+            {"tail": 0, "head": 1, "distance": 5, "demand": 10,
+             "travel_time": [{"piece_end": 40, "speed": 0.5}, {"piece_end": 100, "speed": 1.25}]},
+            {"tail": 1, "head": 2, "distance": 7.5, "demand": 0, "travel_time": [{"piece_end": 100, "speed": 1}]}
+        ]}
+    })";
+    std::istringstream stream(text);
+    nlohmann::json attributes;
+    TDCARPInstance read = read_tdcarp_instance(stream, &attributes);
+    nlohmann::json document = nlohmann::json::parse(text);
+    TDCARPInstance converted = document;
+
+    document.erase("graph");
+    ASSERT_EQ(document, attributes);
+    ASSERT_EQ(converted.vertex_count, read.vertex_count);
+    ASSERT_EQ(converted.depot, read.depot);
+    ASSERT_EQ(converted.horizon, read.horizon);
+    ASSERT_EQ(converted.service_speed_factor, read.service_speed_factor);
+    ASSERT_EQ(converted.capacity, read.capacity);
+    ASSERT_EQ(converted.edges.size(), read.edges.size());
+    for (int k = 0; k < converted.edges.size(); ++k) {
+        ASSERT_EQ(converted.edges[k].tail, read.edges[k].tail);
+        ASSERT_EQ(converted.edges[k].head, read.edges[k].head);
+        ASSERT_EQ(converted.edges[k].distance, read.edges[k].distance);
+        ASSERT_EQ(converted.edges[k].demand, read.edges[k].demand);
+        ASSERT_EQ(converted.edges[k].piece_ends, read.edges[k].piece_ends);
+        ASSERT_EQ(converted.edges[k].speeds, read.edges[k].speeds);
+    }
+}
+
+TEST(FirstTest, ReadNonObjectInstance) {
+    for (std::string text: {"[1, 2]", "42", "\"instance\"", "null", "true"}) {
+        std::istringstream stream(text);
+        nlohmann::json attributes;
+        EXPECT_ANY_THROW(read_vrp_instance(stream, &attributes));
+        std::istringstream tdcarp_stream(text);
+        EXPECT_ANY_THROW(read_tdcarp_instance(tdcarp_stream, &attributes));
+    }
+}
+
 // The Asserts aren't really doing anything... Figure out why.
 
 // Dummy 5: Test that multiple runs of Bellman-Ford doesn't collide with each other.